@@ -0,0 +1,5 @@
+#define SEDCLI_KMIP_VERSION ("1.2")
+#define SEDCLI_VERSION ("1.2")
+#define _GNU_SOURCE
+#define __CHECK_ENDIAN__
+#define SEDCLI_DEBUG_LOGGING
@@ -0,0 +1,16 @@
+CC=gcc
+INCLUDES=./lib/include
+CFLAGS+=-include config.h
+CFLAGS+=-fcommon
+CFLAGS+=-g -std=c17
+CFLAGS+=-fstack-protector-all
+LDFLAGS+=-L.
+LDFLAGS+=-fcommon
+LIB_DIR=/usr/lib64
+LDFLAGS+=-fsanitize=address -fsanitize=undefined
+CFLAGS+=-fsanitize=address -fsanitize=undefined
+CFLAGS+=-Wall -Werror -Wextra
+CFLAGS+=-O0
+CONFIG_KMIP=y
+INCLUDES+=./libkmip/local/include
+LDFLAGS_KMIP+=-lkmip -lcrypto -lssl
@@ -13,6 +13,12 @@
 
 #define OPAL_UID_LENGTH 8
 
+/*
+ * UIDs are kept in 64-bit integers holding the UID bytes in big-endian
+ * order, e.g. the Admin SP 00-00-02-05-00-00-00-01 is 0x0000020500000001.
+ */
+typedef uint64_t sed_uid_t;
+
 #define SED_MAX_KEY_LEN 255
 
 #define SED_OPAL_MAX_LRS 9
@@ -356,6 +362,7 @@ struct opal_req_item {
     union {
         uint8_t byte;
         uint64_t uint;
+        sed_uid_t uid;
         const uint8_t *bytes;
     } val;
 };
@@ -370,13 +377,22 @@ struct sed_opal_col_info {
 
 struct sed_locking_object {
     uint32_t nsid; /* NS id assigned */
-    uint8_t uid[OPAL_UID_LENGTH]; /* Locking Object UID */
+    sed_uid_t uid; /* Locking Object UID */
     uint8_t nsgid; /* True or False */
 };
 
 struct sed_next_uids {
-    uint8_t **uids;
-    uint32_t size;
+    sed_uid_t *uids;   /* one contiguous array, reused by the next call */
+    uint32_t size;     /* UIDs returned by the last call */
+    uint32_t capacity; /* UIDs uids can hold without growing */
+};
+
+struct sed_table_iter {
+    sed_uid_t uid;             /* table being enumerated */
+    sed_uid_t where;           /* last row returned, 0 before the first page */
+    uint16_t count;            /* rows asked for per page, 0 lets the TPer decide */
+    bool done;
+    struct sed_next_uids page; /* rows of the last page */
 };
 
 struct sed_session {
@@ -384,6 +400,30 @@ struct sed_session {
     uint32_t tsn;
 };
 
+struct sed_profile {
+    uint32_t poll_interval;  /* us between IF-RECV polls while a response is pending */
+    uint32_t max_read_table; /* max bytes requested by a single Get on a byte table */
+    uint32_t min_io_buf_len; /* I/O buffer length used until TPer properties are known */
+};
+
+#define SED_STATE_NAME_LEN 32
+
+/*
+ * Last known state of a drive as published in the shared state table by the
+ * processes operating on it. Locking range bits are only valid for the ranges
+ * set in lr_known.
+ */
+struct sed_state {
+    char dev_name[SED_STATE_NAME_LEN];
+    struct sed_locking_feat locking;
+    uint16_t lr_known;
+    uint16_t lr_read_locked;
+    uint16_t lr_write_locked;
+    int32_t last_error;
+    uint32_t last_op_latency;  /* us spent in the last operation */
+    uint64_t updated;          /* seconds since the Epoch */
+};
+
 enum sed_status {
     SED_SUCCESS,
     SED_NOT_AUTHORIZED,
@@ -432,23 +472,23 @@ int sed_get_msid_pin(struct sed_device *dev, struct sed_key *msid_pin);
 int sed_take_ownership(struct sed_device *dev, const struct sed_key *key);
 
 int sed_activate_sp(struct sed_device *dev, const struct sed_key *key,
-    uint8_t *sp_uid, uint8_t *auth_uid, uint8_t *target_sp_uid, char *lr_str,
+    sed_uid_t sp_uid, sed_uid_t auth_uid, sed_uid_t target_sp_uid, char *lr_str,
     uint8_t range_start_length_policy, char *dsts_str);
 
 int sed_setup_global_range(struct sed_device *dev, const struct sed_key *key,
     enum SED_FLAG_TYPE rle, enum SED_FLAG_TYPE wle);
 
 int sed_lock_unlock(struct sed_device *dev, const struct sed_key *key,
-    uint8_t *auth_uid, uint8_t lr, bool sum, enum SED_ACCESS_TYPE access_type);
+    sed_uid_t auth_uid, uint8_t lr, bool sum, enum SED_ACCESS_TYPE access_type);
 
 int sed_revert(struct sed_device *dev, const struct sed_key *key,
-    uint8_t *sp_uid, uint8_t *auth_uid, uint8_t *target_sp_uid);
+    sed_uid_t sp_uid, sed_uid_t auth_uid, sed_uid_t target_sp_uid);
 
 int sed_revert_lsp(struct sed_device *dev, const struct sed_key *key,
-    uint8_t *auth_uid, bool keep_global_range_key);
+    sed_uid_t auth_uid, bool keep_global_range_key);
 
-int sed_set_password(struct sed_device *dev, uint8_t *sp_uid, uint8_t *auth_uid,
-    const struct sed_key *auth_key, uint8_t *user_uid,
+int sed_set_password(struct sed_device *dev, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    const struct sed_key *auth_key, sed_uid_t user_uid,
     const struct sed_key *new_user_key);
 
 int sed_list_lr(struct sed_device *dev, const struct sed_key *key,
@@ -481,37 +521,54 @@ int sed_add_user_to_lr(struct sed_device *dev, const struct sed_key *key,
     const char *user, enum SED_ACCESS_TYPE access_type, uint8_t lr);
 
 int sed_setup_lr(struct sed_device *dev, const struct sed_key *key,
-    uint8_t *sp_uid, uint8_t *auth_uid, uint8_t *lr_uid, uint64_t range_start,
+    sed_uid_t sp_uid, sed_uid_t auth_uid, sed_uid_t lr_uid, uint64_t range_start,
     uint64_t range_length, enum SED_FLAG_TYPE rle, enum SED_FLAG_TYPE wle);
 
 int sed_enable_user(struct sed_device *dev, const struct sed_key *key,
-    uint8_t *sp_uid, uint8_t *auth_uid, uint8_t *user_uid);
+    sed_uid_t sp_uid, sed_uid_t auth_uid, sed_uid_t user_uid);
+
+/**
+ * Enable count users within a single session of given authority. When
+ * user_keys is given, the password of each user is set to its key and
+ * verified by adding the user to the same session with Authenticate.
+ */
+int sed_enable_users(struct sed_device *dev, const struct sed_key *key,
+    sed_uid_t sp_uid, sed_uid_t auth_uid, const sed_uid_t *user_uids,
+    const struct sed_key *user_keys, uint8_t count);
 
 int sed_erase(struct sed_device *dev, const struct sed_key *key,
-    uint8_t *sp_uid, uint8_t *auth_uid, uint8_t *uid);
+    sed_uid_t sp_uid, sed_uid_t auth_uid, sed_uid_t uid);
 
 int sed_genkey(struct sed_device *dev, const struct sed_key *key,
-    uint8_t *sp_uid, uint8_t *auth_uid, uint8_t *uid,
+    sed_uid_t sp_uid, sed_uid_t auth_uid, sed_uid_t uid,
     uint32_t public_exponent, uint32_t pin_length);
 
 int sed_start_session(struct sed_device *dev, const struct sed_key *key,
-    uint8_t *sp_uid, uint8_t *auth_uid, struct sed_session *session);
+    sed_uid_t sp_uid, sed_uid_t auth_uid, struct sed_session *session);
 
 int sed_end_session(struct sed_device *dev, struct sed_session *session);
 
+/**
+ * Add an authority to an open session using the Authenticate method, so that
+ * the session holds the rights of all authenticated authorities. When
+ * session is NULL the session currently open on dev is used.
+ */
+int sed_session_authenticate(struct sed_device *dev, struct sed_session *session,
+    sed_uid_t auth_uid, const struct sed_key *key);
+
 int sed_start_end_transactions(struct sed_device *dev, bool start,
     uint8_t status);
 
 int sed_set_with_buf(struct sed_device *dev, const struct sed_key *key,
-    uint8_t *sp_uid, uint8_t *auth_uid, uint8_t *uid, struct opal_req_item *cmd,
+    sed_uid_t sp_uid, sed_uid_t auth_uid, sed_uid_t uid, struct opal_req_item *cmd,
     size_t cmd_len);
 
 int sed_get_set_col_val(struct sed_device *dev, const struct sed_key *key,
-    uint8_t *sp_uid, uint8_t *auth_uid, uint8_t *uid, uint64_t col,
+    sed_uid_t sp_uid, sed_uid_t auth_uid, sed_uid_t uid, uint64_t col,
     bool get, struct sed_opal_col_info *col_info);
 
 int sed_get_set_byte_table(struct sed_device *dev, const struct sed_key *key,
-    const enum SED_SP_TYPE sp, const char *user, uint8_t *uid, uint64_t start,
+    const enum SED_SP_TYPE sp, const char *user, sed_uid_t uid, uint64_t start,
     uint64_t end, uint8_t *buffer, bool is_set);
 
 int sed_stack_reset(struct sed_device *dev, int32_t com_id, uint64_t extended_com_id, uint8_t *response);
@@ -519,27 +576,87 @@ int sed_stack_reset(struct sed_device *dev, int32_t com_id, uint64_t extended_co
 int sed_tper_reset(struct sed_device *dev);
 
 int sed_reactivate_sp(struct sed_device *dev, const struct sed_key *key,
-    uint8_t *sp_uid, uint8_t *auth_uid, uint8_t *target_sp_uid, char *lr_str,
+    sed_uid_t sp_uid, sed_uid_t auth_uid, sed_uid_t target_sp_uid, char *lr_str,
     uint8_t range_start_length_policy, const struct sed_key *admin1_pwd,
     char *dsts_str);
 
 int sed_assign(struct sed_device *dev, const struct sed_key *key,
-    uint8_t *sp_uid, uint8_t *auth_uid, uint32_t nsid,
+    sed_uid_t sp_uid, sed_uid_t auth_uid, uint32_t nsid,
     uint8_t range_start, uint8_t range_length, struct sed_locking_object *info);
 
 int sed_deassign(struct sed_device *dev, const struct sed_key *key,
-    uint8_t *sp_uid, uint8_t *auth_uid, const uint8_t *uid,
+    sed_uid_t sp_uid, sed_uid_t auth_uid, sed_uid_t uid,
     bool keep_ns_global_range_key);
 
+/**
+ * Fill next_uids with the UIDs of up to count rows of table uid following
+ * row where. next_uids must be zero-initialized before its first use, its
+ * array is reused and grown by later calls and must be released with
+ * sed_next_uids_free().
+ */
 int sed_table_next(struct sed_device *dev, const struct sed_key *key,
-    uint8_t *sp_uid, uint8_t *auth_uid, uint8_t *uid,
-    uint8_t *where, uint16_t count, struct sed_next_uids *next_uids);
+    sed_uid_t sp_uid, sed_uid_t auth_uid, sed_uid_t uid,
+    sed_uid_t where, uint16_t count, struct sed_next_uids *next_uids);
 
 int sed_authenticate(struct sed_device *dev, enum SED_AUTHORITY auth,
     const struct sed_key *key);
 
+/**
+ * Fill next_uids with the UIDs of the ACEs in the ACL of method_uid invoked
+ * on invoking_uid. next_uids must be zero-initialized before its first use
+ * and released with sed_next_uids_free().
+ */
 int sed_get_acl(struct sed_device *dev, const struct sed_key *key,
-    uint8_t *sp_uid, uint8_t *auth_uid, const uint8_t *invoking_uid,
-    const uint8_t *method_uid, struct sed_next_uids *next_uids);
+    sed_uid_t sp_uid, sed_uid_t auth_uid, sed_uid_t invoking_uid,
+    sed_uid_t method_uid, struct sed_next_uids *next_uids);
+
+/**
+ * Release the UID array of next_uids filled by sed_table_next(),
+ * sed_get_acl() or a table iterator.
+ */
+void sed_next_uids_free(struct sed_next_uids *next_uids);
+
+/**
+ * Open a session of given authority and prepare iter to page through the
+ * rows of table uid with Next, count rows at a time. The session stays open
+ * until sed_table_iter_end(), no other command shall be issued on dev in
+ * between.
+ */
+int sed_table_iter_start(struct sed_device *dev, const struct sed_key *key,
+    sed_uid_t sp_uid, sed_uid_t auth_uid, sed_uid_t uid, uint16_t count,
+    struct sed_table_iter *iter);
+
+/**
+ * Fetch the next page of rows into iter->page, reusing its buffer. A page
+ * may hold fewer than count rows, the table is exhausted once a page comes
+ * back empty, then iter->done is set. A TPer that returns a page ending in
+ * the row the page was asked to follow fails the iteration with -EIO.
+ */
+int sed_table_iter_next(struct sed_device *dev, struct sed_table_iter *iter);
+
+/**
+ * Close the session opened by sed_table_iter_start() and release the page.
+ */
+int sed_table_iter_end(struct sed_device *dev, struct sed_table_iter *iter);
+
+/**
+ * Returns the performance profile applied to the device by sed_init(). The
+ * profile is picked from the profile database by drive model and firmware.
+ */
+int sed_get_profile(struct sed_device *dev, struct sed_profile *profile);
+
+/**
+ * Measures the device using read-only operations only, applies the resulting
+ * profile and, if store is set, saves it in the profile database for the
+ * drive model and firmware.
+ */
+int sed_tune_profile(struct sed_device *dev, struct sed_profile *profile, bool store);
+
+/**
+ * Reads the state last published for the device from the shared state table
+ * without touching the drive. Only the first call maps the table, later calls
+ * don't enter the kernel. Returns -ENOENT if nothing was published yet.
+ */
+int sed_get_state(const char *dev_path, struct sed_state *state);
 
 #endif /* _LIBSED_H_ */
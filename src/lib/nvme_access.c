@@ -14,7 +14,7 @@
 #define NVME_SECURITY_SEND (0x81)
 #define NVME_SECURITY_RECV (0x82)
 
-#define OPAL_SLEEP (15000)
+#define MIN_POLL_INTERVAL (100)
 
 #define SEND (1)
 #define RECV (0)
@@ -49,8 +49,15 @@ int opal_send(int fd, uint8_t proto_id, uint16_t com_id, uint8_t *buf, int buf_l
     return ret;
 }
 
-int opal_recv(int fd, uint8_t proto_id, uint16_t com_id, uint8_t *buf, int buf_len)
+/*
+ * The TPer answers an IF-RECV for a response that isn't ready yet with
+ * OutstandingData set. Instead of sleeping a full poll interval each time,
+ * start polling quickly and back off up to poll_interval, so fast methods
+ * complete immediately and slow ones don't spin.
+ */
+int opal_recv(int fd, uint8_t proto_id, uint16_t com_id, uint8_t *buf, int buf_len, uint32_t poll_interval)
 {
+    uint32_t delay = MIN_POLL_INTERVAL < poll_interval ? MIN_POLL_INTERVAL : poll_interval;
     int ret;
 
     bool done = false;
@@ -66,7 +73,8 @@ int opal_recv(int fd, uint8_t proto_id, uint16_t com_id, uint8_t *buf, int buf_l
             uint32_t min_transfer = be32toh(header->compacket.min_transfer);
 
             if (outstanding_data != 0 && min_transfer == 0) {
-                usleep(OPAL_SLEEP);
+                usleep(delay);
+                delay = delay * 2 < poll_interval ? delay * 2 : poll_interval;
                 done = false;
             }
         }
@@ -76,7 +84,7 @@ int opal_recv(int fd, uint8_t proto_id, uint16_t com_id, uint8_t *buf, int buf_l
 }
 
 int opal_send_recv(int fd, uint8_t proto_id, uint16_t com_id, uint8_t *req_buf, int req_buf_len, uint8_t *resp_buf,
-    int resp_buf_len)
+    int resp_buf_len, uint32_t poll_interval)
 {
     int ret = 0;
 
@@ -85,7 +93,7 @@ int opal_send_recv(int fd, uint8_t proto_id, uint16_t com_id, uint8_t *req_buf,
     if (ret)
         return ret;
 
-    ret = opal_recv(fd, proto_id, com_id, resp_buf, resp_buf_len);
+    ret = opal_recv(fd, proto_id, com_id, resp_buf, resp_buf_len, poll_interval);
 
 
     return ret;
@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2018-2019, 2022-2023 Solidigm. All Rights Reserved.
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <libgen.h>
+
+#include "nvme_profile.h"
+#include "sedcli_log.h"
+
+#define PROFILE_LINE_LEN  512
+#define PROFILE_FIELDS    5
+#define PROFILE_SEPARATOR '|'
+#define PROFILE_WILDCARD  "*"
+
+static int read_sysfs_attr(const char *dev_name, const char *attr, char *val, size_t len)
+{
+    const char *paths[] = { "/sys/class/block/%s/device/%s", "/sys/class/nvme/%s/%s" };
+    char path[PROFILE_LINE_LEN];
+
+    for (size_t i = 0; i < sizeof(paths) / sizeof(paths[0]); i++) {
+        snprintf(path, sizeof(path), paths[i], dev_name, attr);
+
+        FILE *fp = fopen(path, "r");
+        if (fp == NULL)
+            continue;
+
+        char *ret = fgets(val, len, fp);
+        fclose(fp);
+        if (ret == NULL)
+            continue;
+
+        /* sysfs pads model and firmware with spaces */
+        size_t end = strlen(val);
+        while (end > 0 && (val[end - 1] == '\n' || val[end - 1] == ' '))
+            val[--end] = '\0';
+
+        return 0;
+    }
+
+    return -ENOENT;
+}
+
+int nvme_profile_get_id(const char *dev_path, struct nvme_profile_id *id)
+{
+    char path[PROFILE_LINE_LEN];
+
+    memset(id, 0, sizeof(*id));
+
+    strncpy(path, dev_path, sizeof(path) - 1);
+    path[sizeof(path) - 1] = '\0';
+    const char *dev_name = basename(path);
+
+    int ret = read_sysfs_attr(dev_name, "model", id->model, sizeof(id->model));
+    if (ret)
+        return ret;
+
+    return read_sysfs_attr(dev_name, "firmware_rev", id->firmware, sizeof(id->firmware));
+}
+
+/*
+ * Split a database line into its fields in place. Returns the number of
+ * fields found.
+ */
+static int split_line(char *line, char **fields)
+{
+    int count = 0;
+
+    line[strcspn(line, "\n")] = '\0';
+    if (line[0] == '#' || line[0] == '\0')
+        return 0;
+
+    fields[count++] = line;
+    for (char *p = line; *p != '\0' && count < PROFILE_FIELDS; p++) {
+        if (*p == PROFILE_SEPARATOR) {
+            *p = '\0';
+            fields[count++] = p + 1;
+        }
+    }
+
+    return count;
+}
+
+static int match_score(const struct nvme_profile_id *id, char **fields)
+{
+    bool any_model = !strcmp(fields[0], PROFILE_WILDCARD);
+    bool any_fw = !strcmp(fields[1], PROFILE_WILDCARD);
+
+    if (!any_model && strcmp(fields[0], id->model))
+        return 0;
+
+    if (!any_fw && strcmp(fields[1], id->firmware))
+        return 0;
+
+    if (any_model)
+        return 1;
+
+    return any_fw ? 2 : 3;
+}
+
+static FILE *open_profile_file(void)
+{
+    FILE *fp = fopen(NVME_PROFILE_FILE, "r");
+    if (fp == NULL)
+        fp = fopen(NVME_PROFILE_BKP_FILE, "r");
+
+    return fp;
+}
+
+void nvme_profile_load(const struct nvme_profile_id *id, struct sed_profile *profile)
+{
+    profile->poll_interval = NVME_PROFILE_DEF_POLL_INTERVAL;
+    profile->max_read_table = NVME_PROFILE_DEF_MAX_READ_TABLE;
+    profile->min_io_buf_len = NVME_PROFILE_DEF_MIN_IO_BUF_LEN;
+
+    FILE *fp = open_profile_file();
+    if (fp == NULL)
+        return;
+
+    char line[PROFILE_LINE_LEN];
+    int best = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        char *fields[PROFILE_FIELDS];
+        if (split_line(line, fields) != PROFILE_FIELDS)
+            continue;
+
+        int score = match_score(id, fields);
+        if (score <= best)
+            continue;
+
+        uint32_t poll_interval = strtoul(fields[2], NULL, 10);
+        uint32_t max_read_table = strtoul(fields[3], NULL, 10);
+        uint32_t min_io_buf_len = strtoul(fields[4], NULL, 10);
+        if (poll_interval == 0 || max_read_table == 0 || min_io_buf_len < NVME_PROFILE_DEF_MIN_IO_BUF_LEN) {
+            SEDCLI_DEBUG_PARAM("Ignoring invalid profile for %s %s\n", fields[0], fields[1]);
+            continue;
+        }
+
+        profile->poll_interval = poll_interval;
+        profile->max_read_table = max_read_table;
+        profile->min_io_buf_len = min_io_buf_len;
+        best = score;
+    }
+
+    fclose(fp);
+
+    SEDCLI_DEBUG_PARAM("Profile for %s %s: poll %u us, read table %u, io buffer %u\n", id->model, id->firmware,
+        profile->poll_interval, profile->max_read_table, profile->min_io_buf_len);
+}
+
+int nvme_profile_store(const struct nvme_profile_id *id, const struct sed_profile *profile)
+{
+    if (id->model[0] == '\0' || id->firmware[0] == '\0')
+        return -EINVAL;
+
+    char tmp_path[PROFILE_LINE_LEN];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", NVME_PROFILE_FILE);
+
+    FILE *out = fopen(tmp_path, "w");
+    if (out == NULL) {
+        SEDCLI_DEBUG_PARAM("Unable to create %s\n", tmp_path);
+        return -errno;
+    }
+
+    /* Copy the database over, leaving out the entry that is replaced */
+    FILE *in = open_profile_file();
+    if (in) {
+        char line[PROFILE_LINE_LEN];
+        while (fgets(line, sizeof(line), in)) {
+            char copy[PROFILE_LINE_LEN];
+            char *fields[PROFILE_FIELDS];
+
+            memcpy(copy, line, sizeof(copy));
+            if (split_line(copy, fields) == PROFILE_FIELDS && match_score(id, fields) == 3)
+                continue;
+
+            fputs(line, out);
+            if (line[strlen(line) - 1] != '\n')
+                fputc('\n', out);
+        }
+        fclose(in);
+    }
+
+    fprintf(out, "%s%c%s%c%u%c%u%c%u\n", id->model, PROFILE_SEPARATOR, id->firmware, PROFILE_SEPARATOR,
+        profile->poll_interval, PROFILE_SEPARATOR, profile->max_read_table, PROFILE_SEPARATOR,
+        profile->min_io_buf_len);
+
+    if (fclose(out) || rename(tmp_path, NVME_PROFILE_FILE)) {
+        int ret = -errno;
+        remove(tmp_path);
+        return ret;
+    }
+
+    return 0;
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2018-2019, 2022-2023 Solidigm. All Rights Reserved.
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef _NVME_PROFILE_H_
+#define _NVME_PROFILE_H_
+
+#include <stdint.h>
+#include "libsed.h"
+
+#define NVME_PROFILE_FILE     "/etc/sedcli/sedcli_profiles"
+#define NVME_PROFILE_BKP_FILE "../etc/sedcli/sedcli_profiles"
+
+#define NVME_PROFILE_ID_LEN 64
+
+#define NVME_PROFILE_DEF_POLL_INTERVAL  15000
+#define NVME_PROFILE_DEF_MAX_READ_TABLE 0x7BD
+#define NVME_PROFILE_DEF_MIN_IO_BUF_LEN 2048
+
+struct nvme_profile_id {
+    char model[NVME_PROFILE_ID_LEN];
+    char firmware[NVME_PROFILE_ID_LEN];
+};
+
+/*
+ * Read model and firmware revision of the controller behind dev_path from
+ * sysfs. Works for both namespace (nvme0n1) and controller (nvme0) nodes.
+ */
+int nvme_profile_get_id(const char *dev_path, struct nvme_profile_id *id);
+
+/*
+ * Fill profile with built-in defaults and override them with the best
+ * matching entry of the profile database: model and firmware match first,
+ * then model with any firmware, then the catch-all entry.
+ */
+void nvme_profile_load(const struct nvme_profile_id *id, struct sed_profile *profile);
+
+/*
+ * Add or replace the entry for given model and firmware in the profile
+ * database.
+ */
+int nvme_profile_store(const struct nvme_profile_id *id, const struct sed_profile *profile);
+
+#endif /* _NVME_PROFILE_H_ */
@@ -18,9 +18,11 @@
 #include <unistd.h>
 #include <stdbool.h>
 #include <assert.h>
+#include <time.h>
 
 #include "nvme_pt_ioctl.h"
 #include "nvme_access.h"
+#include "nvme_profile.h"
 #include "sed_util.h"
 #include "sedcli_log.h"
 #include "opal_parser.h"
@@ -48,8 +50,6 @@
 
 #define ARRAY_SIZE(x) (sizeof(x) / sizeof(x[0]))
 
-#define MIN_IO_BUFFER_LEN 2048
-
 #define OPAL_BLOCK_SID_COMID  5
 #define BLOCK_SID_PAYLOAD_SZ  512
 
@@ -57,6 +57,12 @@
 
 #define OPAL_TPER_RESET_COMID 0x0004
 
+#define OPAL_CREDIT_CONTROL_KIND 0x8001
+#define OPAL_STREAM_MAX_PACKETS  8
+
+#define OPAL_SESSION_TIMEOUT_NAME 5
+#define OPAL_READ_SESSION_TIMEOUT 30000 /* ms asked for the read-only session */
+
 #define MIN(x,y) \
    ({ __typeof__ (x) _x = (x); \
        __typeof__ (y) _y = (y); \
@@ -76,190 +82,124 @@ struct opal_device {
         uint32_t hsn;
         uint32_t tsn;
     } session;
+
+    struct nvme_profile_id profile_id;
+    struct sed_profile profile;
+
+    bool async;
+    bool buff_mgmt;
+    uint32_t seq_num;
+    uint64_t credit;
+
+    /* Read-only Anybody session kept open across read queries */
+    struct {
+        bool open;
+        sed_uid_t sp_uid;
+        uint64_t timeout;  /* negotiated with the TPer, in ms, 0 if not sent */
+        uint64_t refresh;  /* us of inactivity after which it is restarted */
+        uint64_t last_use; /* us, CLOCK_MONOTONIC */
+    } read_session;
 };
 
-uint8_t opal_uid[][OPAL_UID_LENGTH] = {
-    [OPAL_SM_UID] =
-        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff },
-    [OPAL_THIS_SP_UID] =
-        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01 },
-    [OPAL_ADMIN_SP_UID] =
-        { 0x00, 0x00, 0x02, 0x05, 0x00, 0x00, 0x00, 0x01 },
-    [OPAL_LOCKING_SP_UID] =
-        { 0x00, 0x00, 0x02, 0x05, 0x00, 0x00, 0x00, 0x02 },
-    [OPAL_ENTERPRISE_LOCKING_SP_UID] =
-        { 0x00, 0x00, 0x02, 0x05, 0x00, 0x01, 0x00, 0x01 },
+const sed_uid_t opal_uid[] = {
+    [OPAL_SM_UID] = 0x00000000000000FF,
+    [OPAL_THIS_SP_UID] = 0x0000000000000001,
+    [OPAL_ADMIN_SP_UID] = 0x0000020500000001,
+    [OPAL_LOCKING_SP_UID] = 0x0000020500000002,
+    [OPAL_ENTERPRISE_LOCKING_SP_UID] = 0x0000020500010001,
 
     /* authority */
-    [OPAL_ANYBODY_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x01 },
-    [OPAL_ADMINS_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x02 },
-    [OPAL_MAKERS_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x03 },
-    [OPAL_MAKERSYMK_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x04 },
-    [OPAL_MAKERPUK_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x05 },
-    [OPAL_SID_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x06 },
-    [OPAL_PSID_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x01, 0xff, 0x01 },
-    [OPAL_TPERSIGN_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x07 },
-    [OPAL_TPEREXCH_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x08 },
-    [OPAL_ADMINEXCH_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x09 },
-    [OPAL_ISSUERS_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x02, 0x01 },
-    [OPAL_EDITORS_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x02, 0x02 },
-    [OPAL_DELETERS_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x02, 0x03 },
-    [OPAL_SERVERS_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x02, 0x04 },
-    [OPAL_RESERVE0_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x02, 0x05 },
-    [OPAL_RESERVE1_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x02, 0x06 },
-    [OPAL_RESERVE2_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x02, 0x07 },
-    [OPAL_RESERVE3_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x02, 0x08 },
-    [OPAL_ADMIN_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x01, 0x00, 0x00 },
-    [OPAL_ADMIN1_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x01, 0x00, 0x01 },
-    [OPAL_ADMIN2_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x01, 0x00, 0x02 },
-    [OPAL_ADMIN3_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x01, 0x00, 0x03 },
-    [OPAL_ADMIN4_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x01, 0x00, 0x04 },
-    [OPAL_USERS_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x03, 0x00, 0x00 },
-    [OPAL_USER_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x03, 0x00, 0x00 },
-    [OPAL_USER1_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x03, 0x00, 0x01 },
-    [OPAL_USER2_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x03, 0x00, 0x02 },
-    [OPAL_USER3_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x03, 0x00, 0x03 },
-    [OPAL_USER4_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x03, 0x00, 0x04 },
-    [OPAL_USER5_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x03, 0x00, 0x05 },
-    [OPAL_USER6_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x03, 0x00, 0x06 },
-    [OPAL_USER7_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x03, 0x00, 0x07 },
-    [OPAL_USER8_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x03, 0x00, 0x08 },
-    [OPAL_USER9_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x03, 0x00, 0x09 },
-    [OPAL_ENTERPRISE_BANDMASTER0_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x80, 0x01 },
-    [OPAL_ENTERPRISE_ERASEMASTER_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x84, 0x01 },
+    [OPAL_ANYBODY_UID] = 0x0000000900000001,
+    [OPAL_ADMINS_UID] = 0x0000000900000002,
+    [OPAL_MAKERS_UID] = 0x0000000900000003,
+    [OPAL_MAKERSYMK_UID] = 0x0000000900000004,
+    [OPAL_MAKERPUK_UID] = 0x0000000900000005,
+    [OPAL_SID_UID] = 0x0000000900000006,
+    [OPAL_PSID_UID] = 0x000000090001FF01,
+    [OPAL_TPERSIGN_UID] = 0x0000000900000007,
+    [OPAL_TPEREXCH_UID] = 0x0000000900000008,
+    [OPAL_ADMINEXCH_UID] = 0x0000000900000009,
+    [OPAL_ISSUERS_UID] = 0x0000000900000201,
+    [OPAL_EDITORS_UID] = 0x0000000900000202,
+    [OPAL_DELETERS_UID] = 0x0000000900000203,
+    [OPAL_SERVERS_UID] = 0x0000000900000204,
+    [OPAL_RESERVE0_UID] = 0x0000000900000205,
+    [OPAL_RESERVE1_UID] = 0x0000000900000206,
+    [OPAL_RESERVE2_UID] = 0x0000000900000207,
+    [OPAL_RESERVE3_UID] = 0x0000000900000208,
+    [OPAL_ADMIN_UID] = 0x0000000900010000,
+    [OPAL_ADMIN1_UID] = 0x0000000900010001,
+    [OPAL_ADMIN2_UID] = 0x0000000900010002,
+    [OPAL_ADMIN3_UID] = 0x0000000900010003,
+    [OPAL_ADMIN4_UID] = 0x0000000900010004,
+    [OPAL_USERS_UID] = 0x0000000900030000,
+    [OPAL_USER_UID] = 0x0000000900030000,
+    [OPAL_USER1_UID] = 0x0000000900030001,
+    [OPAL_USER2_UID] = 0x0000000900030002,
+    [OPAL_USER3_UID] = 0x0000000900030003,
+    [OPAL_USER4_UID] = 0x0000000900030004,
+    [OPAL_USER5_UID] = 0x0000000900030005,
+    [OPAL_USER6_UID] = 0x0000000900030006,
+    [OPAL_USER7_UID] = 0x0000000900030007,
+    [OPAL_USER8_UID] = 0x0000000900030008,
+    [OPAL_USER9_UID] = 0x0000000900030009,
+    [OPAL_ENTERPRISE_BANDMASTER0_UID] = 0x0000000900008001,
+    [OPAL_ENTERPRISE_ERASEMASTER_UID] = 0x0000000900008401,
 
     /* tables UIDs*/
-    [OPAL_TABLE_TABLE_UID] =
-        { 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01 },
-    [OPAL_LOCKING_TABLE_UID] =
-        { 0x00, 0x00, 0x08, 0x02, 0x00, 0x00, 0x00, 0x00 },
-    [OPAL_LOCKINGRANGE_GLOBAL_UID] =
-        { 0x00, 0x00, 0x08, 0x02, 0x00, 0x00, 0x00, 0x01 },
-    [OPAL_LOCKINGRANGE_ACE_RDLOCKED_UID] =
-        { 0x00, 0x00, 0x00, 0x08, 0x00, 0x03, 0xE0, 0x01 },
-    [OPAL_LOCKINGRANGE_ACE_WRLOCKED_UID] =
-        { 0x00, 0x00, 0x00, 0x08, 0x00, 0x03, 0xE8, 0x01 },
-    [OPAL_MBRCONTROL_UID] =
-        { 0x00, 0x00, 0x08, 0x03, 0x00, 0x00, 0x00, 0x01 },
-    [OPAL_MBR_UID] =
-        { 0x00, 0x00, 0x08, 0x04, 0x00, 0x00, 0x00, 0x00 },
-    [OPAL_AUTHORITY_TABLE_UID] =
-        { 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x00},
-    [OPAL_C_PIN_TABLE_UID] =
-        { 0x00, 0x00, 0x00, 0x0B, 0x00, 0x00, 0x00, 0x00},
-    [OPAL_LOCKING_INFO_TABLE_UID] =
-        { 0x00, 0x00, 0x08, 0x01, 0x00, 0x00, 0x00, 0x01 },
-    [OPAL_ENTERPRISE_LOCKING_INFO_TABLE_UID] =
-        { 0x00, 0x00, 0x08, 0x01, 0x00, 0x00, 0x00, 0x00 },
-    [OPAL_DATASTORE_UID] =
-        { 0x00, 0x00, 0x10, 0x01, 0x00, 0x00, 0x00, 0x00 },
-    [OPAL_ACCESS_CONTROL_UID] =
-        { 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x00 },
+    [OPAL_TABLE_TABLE_UID] = 0x0000000100000001,
+    [OPAL_LOCKING_TABLE_UID] = 0x0000080200000000,
+    [OPAL_LOCKINGRANGE_GLOBAL_UID] = 0x0000080200000001,
+    [OPAL_LOCKINGRANGE_ACE_RDLOCKED_UID] = 0x000000080003E001,
+    [OPAL_LOCKINGRANGE_ACE_WRLOCKED_UID] = 0x000000080003E801,
+    [OPAL_MBRCONTROL_UID] = 0x0000080300000001,
+    [OPAL_MBR_UID] = 0x0000080400000000,
+    [OPAL_AUTHORITY_TABLE_UID] = 0x0000000900000000,
+    [OPAL_C_PIN_TABLE_UID] = 0x0000000B00000000,
+    [OPAL_LOCKING_INFO_TABLE_UID] = 0x0000080100000001,
+    [OPAL_ENTERPRISE_LOCKING_INFO_TABLE_UID] = 0x0000080100000000,
+    [OPAL_DATASTORE_UID] = 0x0000100100000000,
+    [OPAL_ACCESS_CONTROL_UID] = 0x0000000700000000,
 
     /* C_PIN_TABLE object UIDs */
-    [OPAL_C_PIN_MSID_UID] =
-        { 0x00, 0x00, 0x00, 0x0B, 0x00, 0x00, 0x84, 0x02},
-    [OPAL_C_PIN_SID_UID] =
-        { 0x00, 0x00, 0x00, 0x0B, 0x00, 0x00, 0x00, 0x01},
-    [OPAL_C_PIN_ADMIN_SP_ADMIN1_UID] =
-        { 0x00, 0x00, 0x00, 0x0B, 0x00, 0x00, 0x02, 0x01}, // ADMIN SP
-    [OPAL_C_PIN_LOCKING_SP_ADMIN1_UID] =
-        { 0x00, 0x00, 0x00, 0x0B, 0x00, 0x01, 0x00, 0x01}, // LOCKING SP
-    [OPAL_C_PIN_USER1_UID] =
-        { 0x00, 0x00, 0x00, 0x0B, 0x00, 0x03, 0x00, 0x01},
+    [OPAL_C_PIN_MSID_UID] = 0x0000000B00008402,
+    [OPAL_C_PIN_SID_UID] = 0x0000000B00000001,
+    [OPAL_C_PIN_ADMIN_SP_ADMIN1_UID] = 0x0000000B00000201, // ADMIN SP
+    [OPAL_C_PIN_LOCKING_SP_ADMIN1_UID] = 0x0000000B00010001, // LOCKING SP
+    [OPAL_C_PIN_USER1_UID] = 0x0000000B00030001,
 
     /* half UID's (only first 4 bytes used) */
-    [OPAL_HALF_UID_AUTHORITY_OBJ_REF_UID] =
-        { 0x00, 0x00, 0x0C, 0x05, 0xff, 0xff, 0xff, 0xff },
-    [OPAL_HALF_UID_BOOLEAN_ACE_UID] =
-        { 0x00, 0x00, 0x04, 0x0E, 0xff, 0xff, 0xff, 0xff },
+    [OPAL_HALF_UID_AUTHORITY_OBJ_REF_UID] = 0x00000C05FFFFFFFF,
+    [OPAL_HALF_UID_BOOLEAN_ACE_UID] = 0x0000040EFFFFFFFF,
 
     /* ACE DS UIDs */
-    [OPAL_ACE_DS_GET_ALL_UID] =
-        { 0x00, 0x00, 0x00, 0x08, 0x00, 0x03, 0xfc, 0x00 },
-    [OPAL_ACE_DS_SET_ALL_UID] =
-        { 0x00, 0x00, 0x00, 0x08, 0x00, 0x03, 0xfc, 0x01 },
+    [OPAL_ACE_DS_GET_ALL_UID] = 0x000000080003FC00,
+    [OPAL_ACE_DS_SET_ALL_UID] = 0x000000080003FC01,
 
     /* special value for omitted optional parameter */
-    [OPAL_UID_HEXFF_UID] =
-        { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff},
+    [OPAL_UID_HEXFF_UID] = 0xFFFFFFFFFFFFFFFF,
 };
 
-static uint8_t opal_method[][OPAL_UID_LENGTH] = {
-    [OPAL_PROPERTIES_METHOD_UID] =
-        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0x01 },
-    [OPAL_STARTSESSION_METHOD_UID] =
-        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0x02 },
-    [OPAL_REVERT_METHOD_UID] =
-        { 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x02, 0x02 },
-    [OPAL_ACTIVATE_METHOD_UID] =
-        { 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x02, 0x03 },
-    [OPAL_EGET_METHOD_UID] =
-        { 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x06 },
-    [OPAL_ESET_METHOD_UID] =
-        { 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x07 },
-    [OPAL_NEXT_METHOD_UID] =
-        { 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x08 },
-    [OPAL_EAUTHENTICATE_METHOD_UID] =
-        { 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x0c },
-    [OPAL_GETACL_METHOD_UID] =
-        { 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x0d },
-    [OPAL_GENKEY_METHOD_UID] =
-        { 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x10 },
-    [OPAL_REVERTSP_METHOD_UID] =
-        { 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x11 },
-    [OPAL_GET_METHOD_UID] =
-        { 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x16 },
-    [OPAL_SET_METHOD_UID] =
-        { 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x17 },
-    [OPAL_AUTHENTICATE_METHOD_UID] =
-        { 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x1c },
-    [OPAL_RANDOM_METHOD_UID] =
-        { 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x06, 0x01 },
-    [OPAL_ERASE_METHOD_UID] =
-        { 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x08, 0x03 },
-    [OPAL_REACTIVATE_METHOD_UID] =
-        { 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x08, 0x01 },
-    [OPAL_ASSIGN_METHOD_UID] =
-        { 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x08, 0x04 },
-    [OPAL_DEASSIGN_METHOD_UID] =
-        { 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x08, 0x05 },
+static const sed_uid_t opal_method[] = {
+    [OPAL_PROPERTIES_METHOD_UID] = 0x000000000000FF01,
+    [OPAL_STARTSESSION_METHOD_UID] = 0x000000000000FF02,
+    [OPAL_REVERT_METHOD_UID] = 0x0000000600000202,
+    [OPAL_ACTIVATE_METHOD_UID] = 0x0000000600000203,
+    [OPAL_EGET_METHOD_UID] = 0x0000000600000006,
+    [OPAL_ESET_METHOD_UID] = 0x0000000600000007,
+    [OPAL_NEXT_METHOD_UID] = 0x0000000600000008,
+    [OPAL_EAUTHENTICATE_METHOD_UID] = 0x000000060000000C,
+    [OPAL_GETACL_METHOD_UID] = 0x000000060000000D,
+    [OPAL_GENKEY_METHOD_UID] = 0x0000000600000010,
+    [OPAL_REVERTSP_METHOD_UID] = 0x0000000600000011,
+    [OPAL_GET_METHOD_UID] = 0x0000000600000016,
+    [OPAL_SET_METHOD_UID] = 0x0000000600000017,
+    [OPAL_AUTHENTICATE_METHOD_UID] = 0x000000060000001C,
+    [OPAL_RANDOM_METHOD_UID] = 0x0000000600000601,
+    [OPAL_ERASE_METHOD_UID] = 0x0000000600000803,
+    [OPAL_REACTIVATE_METHOD_UID] = 0x0000000600000801,
+    [OPAL_ASSIGN_METHOD_UID] = 0x0000000600000804,
+    [OPAL_DEASSIGN_METHOD_UID] = 0x0000000600000805,
 };
 
 extern uint32_t nvme_error;
@@ -268,6 +208,10 @@ static int opal_dev_discovery(struct sed_device *dev);
 
 static int opal_host_prop(struct sed_device *dev, const char *props, uint32_t *vals);
 
+static int opal_end_session(int fd, struct opal_device *dev);
+
+static void opal_close_read_session(int fd, struct opal_device *dev);
+
 static int opal_level0_discovery_pt(struct sed_device *device)
 {
     struct opal_l0_feat *curr_feat;
@@ -282,7 +226,8 @@ static int opal_level0_discovery_pt(struct sed_device *device)
     uint8_t *buffer;
 
     SEDCLI_DEBUG_MSG("Starting discovery.\n");
-    int ret = opal_recv(device->fd, TCG_SECP_01, OPAL_DISCOVERY_COMID, dev->resp_buf, dev->resp_buf_size);
+    int ret = opal_recv(device->fd, TCG_SECP_01, OPAL_DISCOVERY_COMID, dev->resp_buf, dev->resp_buf_size,
+        dev->profile.poll_interval);
     if (ret) {
         SEDCLI_DEBUG_PARAM("NVMe error during discovery: %d\n", ret);
         nvme_error = ret;
@@ -510,6 +455,9 @@ static int opal_level0_discovery_pt(struct sed_device *device)
 
 void opal_deinit_pt(struct sed_device *dev)
 {
+    if (dev->fd != 0 && dev->priv != NULL)
+        opal_close_read_session(dev->fd, dev->priv);
+
     if (dev->fd != 0) {
         close(dev->fd);
         dev->fd = 0;
@@ -571,6 +519,38 @@ static int resize_io_buf(struct opal_device *dev, uint64_t size)
     return SED_SUCCESS;
 }
 
+/*
+ * Pick the timeout asked for the read-only session within the limits the
+ * TPer reported in Properties and restart the session at three quarters of
+ * it, well before the TPer would close it.
+ */
+static void negotiate_read_session_timeout(struct sed_device *dev)
+{
+    struct opal_device *opal_dev = dev->priv;
+    uint64_t timeout = OPAL_READ_SESSION_TIMEOUT, min = 0, max = 0, def = 0;
+
+    bool has_min = tper_prop_to_val(dev, "MinSessionTimeout", &min) == SED_SUCCESS;
+    bool has_max = tper_prop_to_val(dev, "MaxSessionTimeout", &max) == SED_SUCCESS;
+    tper_prop_to_val(dev, "DefSessionTimeout", &def);
+
+    if (!has_min && !has_max) {
+        /* The TPer didn't report its limits, live with its default */
+        opal_dev->read_session.timeout = 0;
+        timeout = def ? def : OPAL_READ_SESSION_TIMEOUT;
+    } else {
+        /* A limit of 0 means there is no limit */
+        if (timeout < min)
+            timeout = min;
+        if (max != 0 && timeout > max)
+            timeout = max;
+        opal_dev->read_session.timeout = timeout;
+    }
+
+    opal_dev->read_session.refresh = timeout * 1000 / 4 * 3;
+
+    SEDCLI_DEBUG_PARAM("Read-only session timeout %lu ms\n", timeout);
+}
+
 int opal_init_pt(struct sed_device *dev, const char *device_path, bool try)
 {
     dev->fd = 0;
@@ -606,7 +586,12 @@ int opal_init_pt(struct sed_device *dev, const char *device_path, bool try)
     opal_dev->session.tsn = opal_dev->session.hsn = 0;
     opal_dev->req_buf = opal_dev->resp_buf = NULL;
 
-    ret = resize_io_buf(opal_dev, MIN_IO_BUFFER_LEN);
+    if (nvme_profile_get_id(device_path, &opal_dev->profile_id)) {
+        SEDCLI_DEBUG_PARAM("Unable to identify %s, using default profile\n", device_path);
+    }
+    nvme_profile_load(&opal_dev->profile_id, &opal_dev->profile);
+
+    ret = resize_io_buf(opal_dev, opal_dev->profile.min_io_buf_len);
     if (ret) {
         SEDCLI_DEBUG_MSG("Unable to resize IO buffer.\n");
         goto init_deinit;
@@ -618,6 +603,9 @@ int opal_init_pt(struct sed_device *dev, const char *device_path, bool try)
         goto init_deinit;
     }
 
+    opal_dev->async = dev->discovery.sed_lvl0_discovery.sed_tper.async_supp;
+    opal_dev->buff_mgmt = dev->discovery.sed_lvl0_discovery.sed_tper.buff_mgmt_supp;
+
     int host_prop_ret = opal_host_prop(dev, NULL, NULL);
     if (host_prop_ret == SED_SUCCESS) {
         uint64_t max_com_pkt_sz = 0;
@@ -632,6 +620,8 @@ int opal_init_pt(struct sed_device *dev, const char *device_path, bool try)
         }
     }
 
+    negotiate_read_session_timeout(dev);
+
     // SEDCLI_DEBUG_PARAM("The device comid is: %u, MaxComPacketSize = %ld\n", opal_dev->comid, max_com_pkt_sz);
 
 init_deinit:
@@ -667,6 +657,14 @@ int opal_dev_discovery_pt(struct sed_device *dev, struct sed_opal_device_discove
     return 0;
 }
 
+int opal_refresh_discovery_pt(struct sed_device *dev)
+{
+    if (dev == NULL)
+        return -EINVAL;
+
+    return opal_level0_discovery_pt(dev);
+}
+
 static void build_ext_comid(uint8_t *buff, uint16_t comid)
 {
     buff[0] = comid >> 8;
@@ -683,26 +681,24 @@ static void init_req(struct opal_device *dev)
     build_ext_comid(header->compacket.ext_comid, dev->comid);
 }
 
-static void build_gr_lr(uint8_t *uid, uint8_t lr)
+static sed_uid_t build_gr_lr(uint8_t lr)
 {
-    memset(uid, 0, OPAL_UID_LENGTH);
-    memcpy(uid, opal_uid[OPAL_LOCKINGRANGE_GLOBAL_UID], OPAL_UID_LENGTH);
+    sed_uid_t uid = opal_uid[OPAL_LOCKINGRANGE_GLOBAL_UID];
 
     if (lr == 0)
-        return;
+        return uid;
 
-    uid[5] = LOCKING_RANGE_NON_GLOBAL;
-    uid[7] = lr;
+    uid = uid_set_byte(uid, 5, LOCKING_RANGE_NON_GLOBAL);
 
-    return;
+    return uid_set_byte(uid, 7, lr);
 }
 
-static int opal_rw_lock(struct opal_device *dev, uint8_t *lr_buff, uint32_t l_state, uint8_t lr,
+static int opal_rw_lock(struct opal_device *dev, sed_uid_t *lr_uid, uint32_t l_state, uint8_t lr,
     uint8_t *rl, uint8_t *wl)
 {
     init_req(dev);
 
-    build_gr_lr(lr_buff, lr);
+    *lr_uid = build_gr_lr(lr);
 
     switch (l_state) {
     case SED_ACCESS_RO:
@@ -732,15 +728,15 @@ static int opal_rw_lock(struct opal_device *dev, uint8_t *lr_buff, uint32_t l_st
 }
 
 static void prepare_cmd_init(struct opal_device *dev, uint8_t *buf, size_t buf_len, int *pos,
-    const uint8_t *uid, const uint8_t *method)
+    sed_uid_t uid, sed_uid_t method)
 {
     /* setting up the comid */
     init_req(dev);
 
     /* Initializing the command */
     *pos += append_u8(buf + *pos, buf_len - *pos, OPAL_CALL);
-    *pos += append_bytes(buf + *pos, buf_len - *pos, uid, OPAL_UID_LENGTH);
-    *pos += append_bytes(buf + *pos, buf_len - *pos, method, OPAL_METHOD_LENGTH);
+    *pos += append_uid(buf + *pos, buf_len - *pos, uid);
+    *pos += append_uid(buf + *pos, buf_len - *pos, method);
     *pos += append_u8(buf + *pos, buf_len - *pos, OPAL_STARTLIST);
 }
 
@@ -786,7 +782,7 @@ static void prepare_cmd_header(struct opal_device *dev, uint8_t *buf, uint64_t p
 }
 
 static void prepare_req_buf(struct opal_device *dev, struct opal_req_item *data, int data_len,
-    const uint8_t *uid, const uint8_t *method)
+    sed_uid_t uid, sed_uid_t method)
 {
     int i, pos = 0;
 
@@ -811,6 +807,14 @@ static void prepare_req_buf(struct opal_device *dev, struct opal_req_item *data,
         case OPAL_BYTES:
             pos += append_bytes(buf + pos, buf_len - pos, data[i].val.bytes, data[i].len);
             break;
+
+        case OPAL_UID:
+            pos += append_uid(buf + pos, buf_len - pos, data[i].val.uid);
+            break;
+
+        case OPAL_HALF_UID:
+            pos += append_half_uid(buf + pos, buf_len - pos, data[i].val.uid);
+            break;
         }
     }
 
@@ -880,11 +884,80 @@ static uint8_t check_resp_status(struct opal_parsed_payload *payload)
     return payload->tokens[num - 4 - shift]->vals.uint;
 }
 
-static int opal_snd_rcv_cmd_parse_chk(int fd, struct opal_device *dev, bool end_session)
+/*
+ * Every Opal TPer reports Streaming, even when it talks the synchronous
+ * protocol, so packets are only pipelined when the TPer queues commands
+ * with the asynchronous protocol and grants credit through buffer
+ * management.
+ */
+static bool opal_pipelined(struct opal_device *dev)
 {
-    /* Send command and receive results */
-    int ret = opal_send_recv(fd, TCG_SECP_01, dev->comid, dev->req_buf, dev->req_buf_size, dev->resp_buf,
-        dev->resp_buf_size);
+    return dev->async && dev->buff_mgmt;
+}
+
+/* Sequence numbers and credit start over with every session */
+static void opal_reset_stream(struct opal_device *dev)
+{
+    dev->seq_num = 0;
+    dev->credit = 0;
+}
+
+static int opal_snd_cmd(int fd, struct opal_device *dev)
+{
+    /* Pipelined packets are told apart by their sequence numbers */
+    if (opal_pipelined(dev)) {
+        struct opal_header *header = (struct opal_header *)dev->req_buf;
+        header->packet.seq_num = htobe32(++dev->seq_num);
+    }
+
+    int ret = opal_send(fd, TCG_SECP_01, dev->comid, dev->req_buf, dev->req_buf_size);
+    if (ret) {
+        SEDCLI_DEBUG_PARAM("NVMe error: %d\n", ret);
+        nvme_error = ret;
+    }
+
+    return ret;
+}
+
+/*
+ * With buffer management the TPer grants the host more send credit in
+ * CreditControl subpackets following the data subpacket of a response.
+ */
+static void opal_update_credit(struct opal_device *dev, size_t subpacket_len)
+{
+    struct opal_header *header = (struct opal_header *)dev->resp_buf;
+    uint8_t *packet_buf = (uint8_t *)&header->subpacket;
+    size_t packet_len = MIN((uint64_t)be32toh(header->packet.length),
+        dev->resp_buf_size - sizeof(header->compacket) - sizeof(header->packet));
+    size_t pos = sizeof(header->subpacket) + subpacket_len;
+
+    while (true) {
+        if (pos % 4)
+            pos += 4 - pos % 4;
+
+        if (pos + sizeof(struct opal_subpacket) > packet_len)
+            break;
+
+        struct opal_subpacket *subpacket = (struct opal_subpacket *)(packet_buf + pos);
+        size_t len = be32toh(subpacket->length);
+        pos += sizeof(*subpacket);
+        if (len > packet_len - pos)
+            break;
+
+        if (be16toh(subpacket->kind) == OPAL_CREDIT_CONTROL_KIND && len == sizeof(uint32_t)) {
+            uint32_t credit;
+            memcpy(&credit, packet_buf + pos, sizeof(credit));
+            dev->credit += be32toh(credit);
+            SEDCLI_DEBUG_PARAM("TPer granted %u bytes of credit\n", be32toh(credit));
+        }
+
+        pos += len;
+    }
+}
+
+static int opal_rcv_cmd_parse_chk(int fd, struct opal_device *dev, bool end_session)
+{
+    int ret = opal_recv(fd, TCG_SECP_01, dev->comid, dev->resp_buf, dev->resp_buf_size, dev->profile.poll_interval);
     if (ret) {
         SEDCLI_DEBUG_PARAM("NVMe error: %d\n", ret);
         nvme_error = ret;
@@ -898,6 +971,9 @@ static int opal_snd_rcv_cmd_parse_chk(int fd, struct opal_device *dev, bool end_
         return ret;
     }
 
+    if (dev->buff_mgmt)
+        opal_update_credit(dev, subpacket_len);
+
     if (end_session) {
         dev->session.tsn = 0;
         dev->session.hsn = 0;
@@ -917,6 +993,16 @@ static int opal_snd_rcv_cmd_parse_chk(int fd, struct opal_device *dev, bool end_
     return ret;
 }
 
+static int opal_snd_rcv_cmd_parse_chk(int fd, struct opal_device *dev, bool end_session)
+{
+    /* Send command and receive results */
+    int ret = opal_snd_cmd(fd, dev);
+    if (ret)
+        return ret;
+
+    return opal_rcv_cmd_parse_chk(fd, dev, end_session);
+}
+
 static uint8_t get_payload_string(struct opal_device *dev, uint8_t num)
 {
     uint8_t jmp;
@@ -991,7 +1077,7 @@ static void parse_tper_host_prop(struct sed_device *device)
     }
 }
 
-static int opal_set_buf_prep(struct sed_device *device, uint8_t *uid, struct opal_req_item *cmd, size_t cmd_len)
+static int opal_set_buf_prep(struct sed_device *device, sed_uid_t uid, struct opal_req_item *cmd, size_t cmd_len)
 {
     prepare_req_buf(device->priv, cmd, cmd_len, uid, opal_method[OPAL_SET_METHOD_UID]);
 
@@ -1184,7 +1270,7 @@ put_tokens:
 
 static struct opal_req_item start_sess_cmd[] = {
     { .type = OPAL_U64, .len = 8, .val = { .uint = GENERIC_HOST_SESSION_NUM } },
-    { .type = OPAL_BYTES, .len = 8, .val = { .bytes = NULL } }, /* Admin SP | Locking SP */
+    { .type = OPAL_UID, .len = 8, .val = { .uid = 0 } }, /* Admin SP | Locking SP */
     { .type = OPAL_U8, .len = 1, .val = { .byte = 1 } },
     { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_STARTNAME } },
     { .type = OPAL_U8, .len = 1, .val = { .byte = 0 } },
@@ -1192,7 +1278,7 @@ static struct opal_req_item start_sess_cmd[] = {
     { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_ENDNAME } },
     { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_STARTNAME } },
     { .type = OPAL_U8, .len = 1, .val = { .byte = 3 } },
-    { .type = OPAL_BYTES, .len = 8, .val = { .bytes = NULL } }, /* Host Signing Authority: MSID, SID, PSID */
+    { .type = OPAL_UID, .len = 8, .val = { .uid = 0 } }, /* Host Signing Authority: MSID, SID, PSID */
     { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_ENDNAME } },
 };
 
@@ -1221,10 +1307,10 @@ int opal_host_prop_pt(struct sed_device *dev, const char *props, uint32_t *vals)
     return 0;
 }
 
-static void prep_session_buff(uint8_t *sp_uid, const struct sed_key *key, uint8_t *auth_uid)
+static void prep_session_buff(sed_uid_t sp_uid, const struct sed_key *key, sed_uid_t auth_uid)
 {
     /* SP */
-    start_sess_cmd[1].val.bytes = sp_uid;
+    start_sess_cmd[1].val.uid = sp_uid;
 
     if (!key)
         return;
@@ -1234,13 +1320,16 @@ static void prep_session_buff(uint8_t *sp_uid, const struct sed_key *key, uint8_
     start_sess_cmd[5].len = key->len;
 
     /* Host Signing Authority */
-    start_sess_cmd[9].val.bytes = auth_uid;
+    start_sess_cmd[9].val.uid = auth_uid;
 }
 
-static int opal_start_generic_session(int fd, struct opal_device *dev, uint8_t *sp_uid, uint8_t *auth_uid,
+static int opal_start_generic_session(int fd, struct opal_device *dev, sed_uid_t sp_uid, sed_uid_t auth_uid,
     const struct sed_key *key)
 {
-    bool auth_is_anybody = compare_uid(auth_uid, opal_uid[OPAL_ANYBODY_UID]);
+    /* Only one session is used on the ComID at a time */
+    opal_close_read_session(fd, dev);
+
+    bool auth_is_anybody = auth_uid == opal_uid[OPAL_ANYBODY_UID];
     if (auth_is_anybody == false && key == NULL) {
         SEDCLI_DEBUG_MSG("Must provide password for this authority.\n");
         return -EINVAL;
@@ -1251,12 +1340,13 @@ static int opal_start_generic_session(int fd, struct opal_device *dev, uint8_t *
     if (auth_is_anybody == false) {
         prep_session_buff(sp_uid, key, auth_uid);
     } else {
-        prep_session_buff(sp_uid, NULL, NULL);
+        prep_session_buff(sp_uid, NULL, 0);
         /* Only the first 3 tokens are required for anybody authority */
         cmd_len = 3;
     }
 
     SEDCLI_DEBUG_MSG("Starting generic session...\n");
+    opal_reset_stream(dev);
     prepare_req_buf(dev, start_sess_cmd, cmd_len, opal_uid[OPAL_SM_UID], opal_method[OPAL_STARTSESSION_METHOD_UID]);
 
     int ret = opal_snd_rcv_cmd_parse_chk(fd, dev, false);
@@ -1297,24 +1387,25 @@ static int opal_start_admin1_lsp_session(int fd, struct opal_device *dev, const
     return opal_start_generic_session(fd, dev, opal_uid[OPAL_LOCKING_SP_UID], opal_uid[OPAL_ADMIN1_UID], key);
 }
 
-static int opal_start_auth_session(int fd, struct opal_device *dev, bool sum, uint8_t lr, const uint8_t *lr_uid,
-    const uint8_t *auth_uid, const struct sed_key *key)
+static int opal_start_auth_session(int fd, struct opal_device *dev, bool sum, uint8_t lr, sed_uid_t lr_uid,
+    sed_uid_t auth_uid, const struct sed_key *key)
 {
-    uint8_t user_uid[OPAL_UID_LENGTH];
+    opal_close_read_session(fd, dev);
+
+    sed_uid_t user_uid;
     if (sum) {
-        if (lr_uid != NULL)
-            memcpy(user_uid, lr_uid, OPAL_UID_LENGTH);
-        else {
-            memcpy(user_uid, opal_uid[OPAL_USER1_UID], OPAL_UID_LENGTH);
-            user_uid[7] = lr;
-        }
+        if (lr_uid != 0)
+            user_uid = lr_uid;
+        else
+            user_uid = uid_set_byte(opal_uid[OPAL_USER1_UID], 7, lr);
     } else {
-        memcpy(user_uid, auth_uid, OPAL_UID_LENGTH);
+        user_uid = auth_uid;
     }
 
     prep_session_buff(opal_uid[OPAL_LOCKING_SP_UID], key, user_uid);
 
     SEDCLI_DEBUG_MSG("Starting authority session...\n");
+    opal_reset_stream(dev);
     prepare_req_buf(dev, start_sess_cmd, ARRAY_SIZE(start_sess_cmd), opal_uid[OPAL_SM_UID], opal_method[OPAL_STARTSESSION_METHOD_UID]);
 
     int ret = opal_snd_rcv_cmd_parse_chk(fd, dev, false);
@@ -1352,6 +1443,93 @@ static int opal_end_session(int fd, struct opal_device *dev)
     return ret;
 }
 
+static uint64_t now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static struct opal_req_item start_read_sess_cmd[] = {
+    { .type = OPAL_U64, .len = 8, .val = { .uint = GENERIC_HOST_SESSION_NUM } },
+    { .type = OPAL_UID, .len = 8, .val = { .uid = 0 } }, /* SP */
+    { .type = OPAL_U8, .len = 1, .val = { .byte = 0 } }, /* Read-only */
+    { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_STARTNAME } },
+    { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_SESSION_TIMEOUT_NAME } },
+    { .type = OPAL_U64, .len = 8, .val = { .uint = 0 } }, /* Session timeout in ms */
+    { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_ENDNAME } },
+};
+
+/*
+ * Get a read-only Anybody session on given SP. An open one is reused, so a
+ * read query costs a single round trip, unless it is idle long enough to be
+ * close to the timeout negotiated with the TPer.
+ */
+static int opal_start_read_session(int fd, struct opal_device *dev, sed_uid_t sp_uid)
+{
+    if (dev->read_session.open) {
+        if (dev->read_session.sp_uid == sp_uid &&
+            now_us() - dev->read_session.last_use < dev->read_session.refresh)
+            return 0;
+
+        opal_close_read_session(fd, dev);
+    }
+
+    start_read_sess_cmd[1].val.uid = sp_uid;
+    start_read_sess_cmd[5].val.uint = dev->read_session.timeout;
+
+    /* Without a negotiated timeout the TPer default applies */
+    int cmd_len = dev->read_session.timeout ? ARRAY_SIZE(start_read_sess_cmd) : 3;
+
+    SEDCLI_DEBUG_MSG("Starting read-only session...\n");
+    opal_reset_stream(dev);
+    prepare_req_buf(dev, start_read_sess_cmd, cmd_len, opal_uid[OPAL_SM_UID],
+        opal_method[OPAL_STARTSESSION_METHOD_UID]);
+
+    int ret = opal_snd_rcv_cmd_parse_chk(fd, dev, false);
+    if (ret == 0)
+        ret = validate_session(dev);
+
+    opal_put_all_tokens(dev->payload.tokens, &dev->payload.len);
+
+    if (ret) {
+        SEDCLI_DEBUG_PARAM("Error in starting read-only session: %d\n", ret);
+        return ret;
+    }
+
+    dev->read_session.open = true;
+    dev->read_session.sp_uid = sp_uid;
+    dev->read_session.last_use = now_us();
+
+    return 0;
+}
+
+/* Keep the read-only session for the next query unless this one failed */
+static void opal_end_read_session(int fd, struct opal_device *dev, int status)
+{
+    if (status == 0 && dev->read_session.open) {
+        dev->read_session.last_use = now_us();
+        return;
+    }
+
+    opal_close_read_session(fd, dev);
+}
+
+static void opal_close_read_session(int fd, struct opal_device *dev)
+{
+    if (!dev->read_session.open)
+        return;
+
+    dev->read_session.open = false;
+    opal_end_session(fd, dev);
+
+    /* Even if EndSession failed the session is not used any more */
+    dev->session.hsn = 0;
+    dev->session.tsn = 0;
+}
+
 static int opal_transactions(int fd, struct opal_device *dev, bool start, uint8_t status)
 {
     init_req(dev);
@@ -1376,7 +1554,7 @@ static int opal_transactions(int fd, struct opal_device *dev, bool start, uint8_
      return ret;
 }
 
-static int opal_revert(int fd, struct opal_device *dev, uint8_t *uid)
+static int opal_revert(int fd, struct opal_device *dev, sed_uid_t uid)
 {
     prepare_req_buf(dev, NULL, 0, uid, opal_method[OPAL_REVERT_METHOD_UID]);
 
@@ -1423,7 +1601,7 @@ static struct opal_req_item opal_generic_get_column_cmd[] = {
     { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_ENDLIST } },
 };
 
-static int opal_generic_get_column(int fd, struct opal_device *dev, const uint8_t *uid, uint64_t start_col,
+static void prepare_generic_get_column(struct opal_device *dev, sed_uid_t uid, uint64_t start_col,
     uint64_t end_col)
 {
     opal_generic_get_column_cmd[3].val.uint = start_col;
@@ -1431,6 +1609,12 @@ static int opal_generic_get_column(int fd, struct opal_device *dev, const uint8_
 
     prepare_req_buf(dev, opal_generic_get_column_cmd, ARRAY_SIZE(opal_generic_get_column_cmd), uid,
         opal_method[OPAL_GET_METHOD_UID]);
+}
+
+static int opal_generic_get_column(int fd, struct opal_device *dev, sed_uid_t uid, uint64_t start_col,
+    uint64_t end_col)
+{
+    prepare_generic_get_column(dev, uid, start_col, end_col);
 
     return opal_snd_rcv_cmd_parse_chk(fd, dev, false);
 }
@@ -1447,7 +1631,7 @@ static struct opal_req_item opal_generic_set_column_cmd[] = {
     { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_ENDNAME } },
 };
 
-static int opal_generic_set_column(int fd, struct opal_device *dev, const uint8_t *uid, uint64_t col,
+static int opal_generic_set_column(int fd, struct opal_device *dev, sed_uid_t uid, uint64_t col,
     struct sed_opal_col_info *col_info)
 {
     opal_generic_set_column_cmd[4].val.uint = col;
@@ -1490,7 +1674,7 @@ static struct opal_req_item opal_generic_get_byte_table_cmd[] = {
     { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_ENDLIST } },
 };
 
-static int opal_generic_get_byte_table(int fd, struct opal_device *dev, const uint8_t *uid, uint64_t start_row,
+static int opal_generic_get_byte_table(int fd, struct opal_device *dev, sed_uid_t uid, uint64_t start_row,
     uint64_t end_row)
 {
     opal_generic_get_byte_table_cmd[3].val.uint = start_row;
@@ -1508,8 +1692,8 @@ static int opal_generic_get_byte_table(int fd, struct opal_device *dev, const ui
  */
 #define CMD_END_BYTES_NUM 7
 
-static int opal_generic_set_byte_table(int fd, struct opal_device *dev, const uint8_t *uid, uint64_t start_row,
-    uint64_t end_row, uint8_t *buffer)
+static int opal_generic_set_byte_table(int fd, struct opal_device *dev, sed_uid_t uid, uint64_t start_row,
+    uint64_t end_row, const uint8_t *buffer)
 {
     uint8_t *buf;
     uint64_t len = 0, remaining_buff_size;
@@ -1590,7 +1774,7 @@ put_tokens:
     return ret;
 }
 
-static int opal_activate_sp(int fd, struct opal_device *dev, uint8_t *target_sp_uid, bool reactivate, uint32_t *lr,
+static int opal_activate_sp(int fd, struct opal_device *dev, sed_uid_t target_sp_uid, bool reactivate, uint32_t *lr,
     uint8_t num_lrs, bool is_locking_table, uint8_t range_start_length_policy, uint32_t *dsts, uint8_t num_dsts,
     const struct sed_key *admin1_pwd)
 {
@@ -1605,25 +1789,15 @@ static int opal_activate_sp(int fd, struct opal_device *dev, uint8_t *target_sp_
     if (is_locking_table && num_lrs == 1) {
         pos += append_u8(buf + pos, buf_len - pos, OPAL_STARTNAME);
         pos += append_u64(buf + pos, buf_len - pos, SUM_RANGES);
-        pos += append_bytes(buf + pos, buf_len - pos, opal_uid[OPAL_LOCKING_TABLE_UID], OPAL_UID_LENGTH);
+        pos += append_uid(buf + pos, buf_len - pos, opal_uid[OPAL_LOCKING_TABLE_UID]);
         pos += append_u8(buf + pos, buf_len - pos, OPAL_ENDNAME);
     }
     else if (num_lrs > 0) {
-        uint8_t user_lr[OPAL_UID_LENGTH];
-        memcpy(user_lr, opal_uid[OPAL_LOCKINGRANGE_GLOBAL_UID], OPAL_UID_LENGTH);
-        user_lr[5] = LOCKING_RANGE_NON_GLOBAL;
-
         pos += append_u8(buf + pos, buf_len - pos, OPAL_STARTNAME);
         pos += append_u64(buf + pos, buf_len - pos, SUM_RANGES);
         pos += append_u8(buf + pos, buf_len - pos, OPAL_STARTLIST);
-        for (uint8_t i = 0; i < num_lrs; i++) {
-            if (lr[i] == 0)
-                pos += append_bytes(buf + pos, buf_len - pos, opal_uid[OPAL_LOCKINGRANGE_GLOBAL_UID], OPAL_UID_LENGTH);
-            else {
-                user_lr[7] = lr[i];
-                pos += append_bytes(buf + pos, buf_len - pos, user_lr, OPAL_UID_LENGTH);
-            }
-        }
+        for (uint8_t i = 0; i < num_lrs; i++)
+            pos += append_uid(buf + pos, buf_len - pos, build_gr_lr(lr[i]));
         pos += append_u8(buf + pos, buf_len - pos, OPAL_ENDLIST);
         pos += append_u8(buf + pos, buf_len - pos, OPAL_ENDNAME);
     }
@@ -1672,15 +1846,15 @@ static struct opal_req_item add_user_to_lr_cmd[] = {
     { .type = OPAL_U8, .len = 1, .val = { .byte = 3 } },
     { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_STARTLIST } },
     { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_STARTNAME } },
-    { .type = OPAL_BYTES, .len = 4, .val = { .bytes = opal_uid[OPAL_HALF_UID_AUTHORITY_OBJ_REF_UID] } },
-    { .type = OPAL_BYTES, .len = 8, .val = { .bytes = NULL } },
+    { .type = OPAL_HALF_UID, .len = 4, .val = { .uid = 0 } }, /* Authority object ref */
+    { .type = OPAL_UID, .len = 8, .val = { .uid = 0 } },
     { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_ENDNAME } },
     { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_STARTNAME } },
-    { .type = OPAL_BYTES, .len = 4, .val = { .bytes = opal_uid[OPAL_HALF_UID_AUTHORITY_OBJ_REF_UID] } },
-    { .type = OPAL_BYTES, .len = 8, .val = { .bytes = NULL } },
+    { .type = OPAL_HALF_UID, .len = 4, .val = { .uid = 0 } }, /* Authority object ref */
+    { .type = OPAL_UID, .len = 8, .val = { .uid = 0 } },
     { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_ENDNAME } },
     { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_STARTNAME } },
-    { .type = OPAL_BYTES, .len = 4, .val = { .bytes = opal_uid[OPAL_HALF_UID_BOOLEAN_ACE_UID] } },
+    { .type = OPAL_HALF_UID, .len = 4, .val = { .uid = 0 } }, /* Boolean ACE */
     { .type = OPAL_U8, .len = 1, .val = { .byte = 1 } },
     { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_ENDNAME } },
     { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_ENDLIST } },
@@ -1691,25 +1865,20 @@ static struct opal_req_item add_user_to_lr_cmd[] = {
 
 static int add_user_to_lr(int fd, struct opal_device *dev, uint32_t access_type, uint8_t lr, uint32_t who, bool admin)
 {
-    uint8_t lr_buff[OPAL_UID_LENGTH];
-    memcpy(lr_buff, opal_uid[OPAL_LOCKINGRANGE_ACE_RDLOCKED_UID], OPAL_UID_LENGTH);
+    sed_uid_t ace_uid = opal_uid[access_type == OPAL_RW ? OPAL_LOCKINGRANGE_ACE_WRLOCKED_UID :
+        OPAL_LOCKINGRANGE_ACE_RDLOCKED_UID];
+    ace_uid = uid_set_byte(ace_uid, 7, lr);
 
-    if (access_type == OPAL_RW)
-        memcpy(lr_buff, opal_uid[OPAL_LOCKINGRANGE_ACE_WRLOCKED_UID], OPAL_UID_LENGTH);
+    sed_uid_t user_uid = opal_uid[admin ? OPAL_ADMIN1_UID : OPAL_USER1_UID];
+    user_uid = uid_set_byte(user_uid, 7, who);
 
-    lr_buff[7] = lr;
+    add_user_to_lr_cmd[7].val.uid = opal_uid[OPAL_HALF_UID_AUTHORITY_OBJ_REF_UID];
+    add_user_to_lr_cmd[8].val.uid = user_uid;
+    add_user_to_lr_cmd[11].val.uid = opal_uid[OPAL_HALF_UID_AUTHORITY_OBJ_REF_UID];
+    add_user_to_lr_cmd[12].val.uid = user_uid;
+    add_user_to_lr_cmd[15].val.uid = opal_uid[OPAL_HALF_UID_BOOLEAN_ACE_UID];
 
-    uint8_t user_uid[OPAL_UID_LENGTH];
-    if (admin)
-        memcpy(user_uid, opal_uid[OPAL_ADMIN1_UID], OPAL_UID_LENGTH);
-    else
-        memcpy(user_uid, opal_uid[OPAL_USER1_UID], OPAL_UID_LENGTH);
-    user_uid[7] = who;
-
-    add_user_to_lr_cmd[8].val.bytes = user_uid;
-    add_user_to_lr_cmd[12].val.bytes = user_uid;
-
-    prepare_req_buf(dev, add_user_to_lr_cmd, ARRAY_SIZE(add_user_to_lr_cmd), lr_buff, opal_method[OPAL_SET_METHOD_UID]);
+    prepare_req_buf(dev, add_user_to_lr_cmd, ARRAY_SIZE(add_user_to_lr_cmd), ace_uid, opal_method[OPAL_SET_METHOD_UID]);
 
     int ret = opal_snd_rcv_cmd_parse_chk(fd, dev, false);
 
@@ -1730,7 +1899,7 @@ static struct opal_req_item enable_user_cmd[] = {
     { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_ENDNAME } },
 };
 
-static int opal_enable_user(int fd, struct opal_device *dev, uint8_t *user_uid)
+static int opal_enable_user(int fd, struct opal_device *dev, sed_uid_t user_uid)
 {
     prepare_req_buf(dev, enable_user_cmd, ARRAY_SIZE(enable_user_cmd), user_uid, opal_method[OPAL_SET_METHOD_UID]);
 
@@ -1770,7 +1939,7 @@ static struct opal_req_item generic_enable_disable_global_lr_cmd[] = {
     { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_ENDNAME } },
 };
 
-static void generic_enable_disable_global_lr(struct opal_device *dev, const uint8_t *uid, bool rle, bool wle,
+static void generic_enable_disable_global_lr(struct opal_device *dev, sed_uid_t uid, bool rle, bool wle,
     bool rl, bool wl)
 {
     generic_enable_disable_global_lr_cmd[5].val.byte = rle;
@@ -1835,17 +2004,14 @@ static struct opal_req_item setup_locking_range_rwle[] = {
     { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_ENDNAME } },
 };
 
-static int opal_setup_locking_range(int fd, struct opal_device *dev, uint8_t *uid, uint64_t range_start,
+static int opal_setup_locking_range(int fd, struct opal_device *dev, sed_uid_t uid, uint64_t range_start,
     uint64_t range_length, enum SED_FLAG_TYPE rle, enum SED_FLAG_TYPE wle)
 {
-    uint8_t nonglobal_lr[OPAL_UID_LENGTH];
-    memcpy(nonglobal_lr, opal_uid[OPAL_LOCKINGRANGE_GLOBAL_UID], OPAL_UID_LENGTH);
-    nonglobal_lr[5] = LOCKING_RANGE_NON_GLOBAL;
-    nonglobal_lr[7] = 0;
+    sed_uid_t nonglobal_lr = uid_set_byte(uid_set_byte(opal_uid[OPAL_LOCKINGRANGE_GLOBAL_UID], 5, LOCKING_RANGE_NON_GLOBAL), 7, 0);
 
     struct opal_req_item *cmd = NULL;
 
-    if (!memcmp(uid, nonglobal_lr, ARRAY_SIZE(nonglobal_lr))) {
+    if (uid == nonglobal_lr) {
         generic_enable_disable_global_lr(dev, uid, rle, wle, 0, 0);
     } else {
         setup_locking_range_prefix[5].val.uint = range_start;
@@ -1893,13 +2059,13 @@ static int opal_setup_locking_range(int fd, struct opal_device *dev, uint8_t *ui
 
 static int opal_lock_unlock_sum(int fd, struct opal_device *dev, uint32_t access_type, uint8_t lr)
 {
-    uint8_t lr_buff[OPAL_UID_LENGTH];
+    sed_uid_t lr_uid;
     uint8_t read_lock = 1, write_lock = 1;
-    int ret = opal_rw_lock(dev, lr_buff, access_type, lr, &read_lock, &write_lock);
+    int ret = opal_rw_lock(dev, &lr_uid, access_type, lr, &read_lock, &write_lock);
     if (ret)
         return ret;
 
-    generic_enable_disable_global_lr(dev, lr_buff, 1, 1, read_lock, write_lock);
+    generic_enable_disable_global_lr(dev, lr_uid, 1, 1, read_lock, write_lock);
 
     ret = opal_snd_rcv_cmd_parse_chk(fd, dev, false);
 
@@ -1929,16 +2095,16 @@ static struct opal_req_item opal_lock_unlock_no_sum_cmd[] = {
 
 static int opal_lock_unlock_no_sum(int fd, struct opal_device *dev, uint32_t access_type, uint8_t lr)
 {
-    uint8_t lr_buff[OPAL_UID_LENGTH];
+    sed_uid_t lr_uid;
     uint8_t read_lock = 1, write_lock = 1;
-    int ret = opal_rw_lock(dev, lr_buff, access_type, lr, &read_lock, &write_lock);
+    int ret = opal_rw_lock(dev, &lr_uid, access_type, lr, &read_lock, &write_lock);
     if (ret)
         return ret;
 
     opal_lock_unlock_no_sum_cmd[5].val.byte = read_lock;
     opal_lock_unlock_no_sum_cmd[9].val.byte = write_lock;
 
-    prepare_req_buf(dev, opal_lock_unlock_no_sum_cmd, ARRAY_SIZE(opal_lock_unlock_no_sum_cmd), lr_buff,
+    prepare_req_buf(dev, opal_lock_unlock_no_sum_cmd, ARRAY_SIZE(opal_lock_unlock_no_sum_cmd), lr_uid,
         opal_method[OPAL_SET_METHOD_UID]);
 
     ret = opal_snd_rcv_cmd_parse_chk(fd, dev, false);
@@ -1960,7 +2126,7 @@ static struct opal_req_item generic_pwd_cmd[] = {
     { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_ENDNAME } },
 };
 
-static void generic_pwd_func(struct opal_device *dev, const struct sed_key *key, const uint8_t *auth_uid)
+static void generic_pwd_func(struct opal_device *dev, const struct sed_key *key, sed_uid_t auth_uid)
 {
     generic_pwd_cmd[5].val.bytes = (uint8_t *)key->key;
     generic_pwd_cmd[5].len = key->len;
@@ -1968,7 +2134,7 @@ static void generic_pwd_func(struct opal_device *dev, const struct sed_key *key,
     prepare_req_buf(dev, generic_pwd_cmd, ARRAY_SIZE(generic_pwd_cmd), auth_uid, opal_method[OPAL_SET_METHOD_UID]);
 }
 
-static int opal_set_password(int fd, struct opal_device *dev, uint8_t uid[OPAL_UID_LENGTH], const struct sed_key *key)
+static int opal_set_password(int fd, struct opal_device *dev, sed_uid_t uid, const struct sed_key *key)
 {
     generic_pwd_func(dev, key, uid);
 
@@ -1979,6 +2145,82 @@ static int opal_set_password(int fd, struct opal_device *dev, uint8_t uid[OPAL_U
     return ret;
 }
 
+/* Map an authority to the row of the C_PIN table holding its password */
+static sed_uid_t get_cpin_uid(sed_uid_t user_uid)
+{
+    sed_uid_t uid = user_uid;
+
+    if (user_uid == opal_uid[OPAL_SID_UID]) {
+        SEDCLI_DEBUG_MSG("Setting password for SID user.\n");
+        uid = opal_uid[OPAL_C_PIN_SID_UID];
+    }
+    else if(compare_uid_range(user_uid, opal_uid[OPAL_ADMIN1_UID], 1, 4)) {
+        SEDCLI_DEBUG_MSG("Setting password for admin user from locking sp table.\n");
+        // align last uid byte to given admin id from locking sp
+        uid = uid_set_byte(opal_uid[OPAL_C_PIN_LOCKING_SP_ADMIN1_UID], 7, uid_get_byte(user_uid, 7));
+    } else if(compare_uid_range(user_uid, opal_uid[OPAL_USER1_UID], 1, 9)) {
+        SEDCLI_DEBUG_MSG("Setting password for user from locking sp table.\n");
+        // align last uid byte to given user id
+        uid = uid_set_byte(opal_uid[OPAL_C_PIN_USER1_UID], 7, uid_get_byte(user_uid, 7));
+    } else if(compare_uid_range(user_uid, opal_uid[OPAL_ADMIN1_ADMIN_SP_UID], 1, 9)) {
+        SEDCLI_DEBUG_MSG("Setting password for admin from admin sp table.\n");
+        // align last uid byte to given admin id from admin sp
+        uid = uid_set_byte(opal_uid[OPAL_C_PIN_ADMIN_SP_ADMIN1_UID], 7, uid_get_byte(user_uid, 7));
+    } else if (user_uid == opal_uid[OPAL_C_PIN_SID_UID]) {
+        SEDCLI_DEBUG_MSG("Setting password for SID with C_PIN table.\n");
+    } else if(compare_uid_range(user_uid, opal_uid[OPAL_C_PIN_ADMIN_SP_ADMIN1_UID], 1, 4)) {
+        SEDCLI_DEBUG_MSG("Setting password for admin with C_PIN table from admin sp table.\n");
+    } else if(compare_uid_range(user_uid, opal_uid[OPAL_C_PIN_LOCKING_SP_ADMIN1_UID], 1, 4)) {
+        SEDCLI_DEBUG_MSG("Setting password for admin with C_PIN table from locking sp table.\n");
+    } else if(compare_uid_range(user_uid, opal_uid[OPAL_C_PIN_USER1_UID], 1, 4)) {
+        SEDCLI_DEBUG_MSG("Setting password for user with C_PIN table from locking sp table.\n");
+    } else {
+        SEDCLI_DEBUG_MSG("Setting password - warning - user uid doesn't found.\n");
+    }
+
+    return uid;
+}
+
+static struct opal_req_item authenticate_cmd[] = {
+    { .type = OPAL_UID, .len = 8, .val = { .uid = 0 } }, // Auth UID
+
+    { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_STARTNAME } },
+    { .type = OPAL_U8, .len = 1, .val = { .byte = 0 } },
+    { .type = OPAL_BYTES, .len = 1, .val = { .bytes = NULL } }, // Proof / Host Challenge
+    { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_ENDNAME } },
+};
+
+/*
+ * Add an authority to the open session. The TPer answers a wrong key with a
+ * successful status and a False result, so the result is checked as well.
+ */
+static int opal_authenticate_method(int fd, struct opal_device *dev, sed_uid_t auth_uid, const struct sed_key *key)
+{
+    /* New authority UID */
+    authenticate_cmd[0].val.uid = auth_uid;
+
+    /* Proof/Host Challenge */
+    authenticate_cmd[3].val.bytes = (uint8_t *)key->key;
+    authenticate_cmd[3].len = key->len;
+
+    prepare_req_buf(dev, authenticate_cmd, ARRAY_SIZE(authenticate_cmd), opal_uid[OPAL_THIS_SP_UID],
+        opal_method[OPAL_AUTHENTICATE_METHOD_UID]);
+
+    int ret = opal_snd_rcv_cmd_parse_chk(fd, dev, false);
+    if (ret)
+        goto put_tokens;
+
+    if (dev->payload.len < 2 || dev->payload.tokens[1]->vals.uint != 1) {
+        SEDCLI_DEBUG_MSG("Authority not authenticated.\n");
+        ret = SED_NOT_AUTHORIZED;
+    }
+
+put_tokens:
+    opal_put_all_tokens(dev->payload.tokens, &dev->payload.len);
+
+    return ret;
+}
+
 static struct opal_req_item opal_set_mbr_cmd[] = {
     { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_STARTNAME } },
     { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_VALUES } },
@@ -2017,7 +2259,7 @@ static int opal_set_mbr_en_disable(int fd, struct opal_device *dev, uint8_t en_d
     return opal_set_mbr(fd, dev, OPAL_MBRENABLE, en_disable);
 }
 
-static int opal_erase(int fd, struct opal_device *dev, const uint8_t *uid)
+static int opal_erase(int fd, struct opal_device *dev, sed_uid_t uid)
 {
     prepare_req_buf(dev, NULL, 0, uid, opal_method[OPAL_ERASE_METHOD_UID]);
 
@@ -2030,10 +2272,8 @@ static int opal_erase(int fd, struct opal_device *dev, const uint8_t *uid)
 
 static int get_table_length(int fd, struct opal_device *dev, enum opaluid table, uint64_t *len)
 {
-    uint8_t uid[OPAL_UID_LENGTH];
-    const int half = OPAL_UID_LENGTH / 2;
-    memcpy(uid, opal_uid[OPAL_TABLE_TABLE_UID], half);
-    memcpy(uid + half, opal_uid[table], half);
+    /* Row of the Table table describing given table */
+    sed_uid_t uid = (opal_uid[OPAL_TABLE_TABLE_UID] & 0xFFFFFFFF00000000) | opal_uid[table] >> 32;
 
     int ret = opal_generic_get_column(fd, dev, uid, OPAL_TABLE_ROW, OPAL_TABLE_ROW);
     if (ret) {
@@ -2050,6 +2290,85 @@ put_tokens:
     return ret;
 }
 
+/*
+ * Bookkeeping of the packets sent ahead of their responses when streaming
+ * table data to a TPer.
+ */
+struct opal_stream {
+    struct {
+        uint64_t index;
+        uint64_t len;
+    } packet[OPAL_STREAM_MAX_PACKETS];
+    uint8_t head;
+    uint8_t count;
+};
+
+/* Size of the ComPacket prepared in the request buffer, as charged against the credit */
+static uint64_t opal_req_packet_len(struct opal_device *dev)
+{
+    struct opal_header *header = (struct opal_header *)dev->req_buf;
+
+    return be32toh(header->compacket.length) + sizeof(header->compacket);
+}
+
+/*
+ * More than one packet is only put in flight on pipelining TPers that
+ * granted enough credit for the prepared ComPacket.
+ */
+static bool opal_stream_can_send(struct opal_device *dev, struct opal_stream *stream)
+{
+    if (stream->count == 0)
+        return true;
+
+    if (!opal_pipelined(dev) || stream->count == OPAL_STREAM_MAX_PACKETS)
+        return false;
+
+    return dev->credit >= opal_req_packet_len(dev);
+}
+
+static int opal_stream_send(int fd, struct opal_device *dev, struct opal_stream *stream, uint64_t index,
+    uint64_t len)
+{
+    uint64_t packet_len = opal_req_packet_len(dev);
+
+    int ret = opal_snd_cmd(fd, dev);
+    if (ret)
+        return ret;
+
+    dev->credit -= MIN(dev->credit, packet_len);
+
+    uint8_t slot = (stream->head + stream->count) % OPAL_STREAM_MAX_PACKETS;
+    stream->packet[slot].index = index;
+    stream->packet[slot].len = len;
+    stream->count++;
+
+    return 0;
+}
+
+/*
+ * Collect the response for the oldest packet in flight. Tokens of the
+ * response are left for the caller to put.
+ */
+static int opal_stream_recv(int fd, struct opal_device *dev, struct opal_stream *stream, uint64_t *index)
+{
+    *index = stream->packet[stream->head].index;
+    stream->head = (stream->head + 1) % OPAL_STREAM_MAX_PACKETS;
+    stream->count--;
+
+    return opal_rcv_cmd_parse_chk(fd, dev, false);
+}
+
+/* The session must stay in sync with the TPer, so responses are always drained */
+static void opal_stream_drain(int fd, struct opal_device *dev, struct opal_stream *stream)
+{
+    uint64_t index;
+
+    while (stream->count) {
+        opal_stream_recv(fd, dev, stream, &index);
+        opal_put_all_tokens(dev->payload.tokens, &dev->payload.len);
+    }
+}
+
 static int opal_generic_write_table(int fd, struct opal_device *dev, enum opaluid table, const uint8_t *data,
     uint64_t offset, uint64_t size)
 {
@@ -2057,6 +2376,7 @@ static int opal_generic_write_table(int fd, struct opal_device *dev, enum opalui
     uint64_t len = 0, index = 0, remaining_buff_size;
     int pos = 0;
     size_t buf_len;
+    struct opal_stream stream = { 0 };
 
     if (size == 0)
         return 0;
@@ -2074,48 +2394,70 @@ static int opal_generic_write_table(int fd, struct opal_device *dev, enum opalui
         return -ENOSPC;
     }
 
-    while (index < size) {
-        buf = dev->req_buf + sizeof(struct opal_header);
-        buf_len = dev->req_buf_size - sizeof(struct opal_header);
-
-        prepare_cmd_init(dev, buf, buf_len, &pos, opal_uid[table], opal_method[OPAL_SET_METHOD_UID]);
-
-        pos += append_u8(buf + pos, buf_len - pos, OPAL_STARTNAME);
-        pos += append_u8(buf + pos, buf_len - pos, OPAL_WHERE);
-        pos += append_u64(buf + pos, buf_len - pos, offset + index);
-        pos += append_u8(buf + pos, buf_len - pos, OPAL_ENDNAME);
-
-        pos += append_u8(buf + pos, buf_len - pos, OPAL_STARTNAME);
-        pos += append_u8(buf + pos, buf_len - pos, OPAL_VALUES);
+    buf = dev->req_buf + sizeof(struct opal_header);
+    buf_len = dev->req_buf_size - sizeof(struct opal_header);
 
-        /*
-         * The append_bytes used below, dependng upon the len either uses
-         * short_atom_bytes_header (returns 1) or medium_atom_bytes_header
-         * (returns 2) or long_atom_bytes_header (returns 4).
-         * Hence we consider the MAX of the three i.e, 4.
-         *
-         * The 1 byte is for the following ENDNAME token.
-         */
-        remaining_buff_size = buf_len - (pos + 4 + 1 + CMD_END_BYTES_NUM);
+    /*
+     * On asynchronous TPers with buffer management the next Set is sent
+     * before the response to the previous one arrives, as long as the window
+     * and the credit granted by the TPer allow it. Otherwise every Set waits
+     * for its response. A prepared Set stays in the request buffer until it
+     * can be sent.
+     */
+    bool pending = false;
+    while (index < size || stream.count) {
+        if (index < size && !pending) {
+            pos = 0;
+            prepare_cmd_init(dev, buf, buf_len, &pos, opal_uid[table], opal_method[OPAL_SET_METHOD_UID]);
+
+            pos += append_u8(buf + pos, buf_len - pos, OPAL_STARTNAME);
+            pos += append_u8(buf + pos, buf_len - pos, OPAL_WHERE);
+            pos += append_u64(buf + pos, buf_len - pos, offset + index);
+            pos += append_u8(buf + pos, buf_len - pos, OPAL_ENDNAME);
+
+            pos += append_u8(buf + pos, buf_len - pos, OPAL_STARTNAME);
+            pos += append_u8(buf + pos, buf_len - pos, OPAL_VALUES);
+
+            /*
+             * The append_bytes used below, dependng upon the len either uses
+             * short_atom_bytes_header (returns 1) or medium_atom_bytes_header
+             * (returns 2) or long_atom_bytes_header (returns 4).
+             * Hence we consider the MAX of the three i.e, 4.
+             *
+             * The 1 byte is for the following ENDNAME token.
+             */
+            remaining_buff_size = buf_len - (pos + 4 + 1 + CMD_END_BYTES_NUM);
+
+            len = MIN(remaining_buff_size, (size - index));
+
+            pos += append_bytes(buf + pos, buf_len - pos, data + index, len);
+            pos += append_u8(buf + pos, buf_len - pos, OPAL_ENDNAME);
+            prepare_cmd_end(buf, buf_len, &pos);
+            prepare_cmd_header(dev, buf, pos);
+            pending = true;
+        }
 
-        len = MIN(remaining_buff_size, (size - index));
+        if (pending && opal_stream_can_send(dev, &stream)) {
+            ret = opal_stream_send(fd, dev, &stream, index, len);
+            if (ret)
+                break;
 
-        pos += append_bytes(buf + pos, buf_len - pos, data, len);
-        pos += append_u8(buf + pos, buf_len - pos, OPAL_ENDNAME);
-        prepare_cmd_end(buf, buf_len, &pos);
-        prepare_cmd_header(dev, buf, pos);
+            pending = false;
+            index += len;
+            continue;
+        }
 
-        ret = opal_snd_rcv_cmd_parse_chk(fd, dev, false);
+        uint64_t done;
+        ret = opal_stream_recv(fd, dev, &stream, &done);
 
         opal_put_all_tokens(dev->payload.tokens, &dev->payload.len);
 
         if (ret)
             break;
-
-        index += len;
-        pos = 0;
     }
 
+    opal_stream_drain(fd, dev, &stream);
+
     return ret;
 }
 
@@ -2144,13 +2486,13 @@ static struct opal_req_item opal_generic_read_table_cmd[] = {
 };
 
 /*
- * IO_BUFFER_LENGTH = 2048
  * sizeof(header) = 56
  * No. of Token Bytes in the Response = 11
  * MAX size of data that can be carried in response buffer
- * at a time is : 2048 - (56 + 11) = 1981 = 0x7BD.
+ * at a time is : IO_BUFFER_LENGTH - (56 + 11), i.e. 0x7BD for
+ * the default 2048 bytes buffer. The profile may lower it further.
  */
-#define OPAL_MAX_READ_TABLE 0x7BD
+#define OPAL_READ_TABLE_OVERHEAD (sizeof(struct opal_header) + 11)
 
 static int opal_generic_read_table(int fd, struct opal_device *dev, enum opaluid table, uint8_t *data, uint64_t offset,
     uint64_t size)
@@ -2175,18 +2517,37 @@ static int opal_generic_read_table(int fd, struct opal_device *dev, enum opaluid
         return -EINVAL;
     }
 
-    while (index < end_row) {
-        opal_generic_read_table_cmd[3].val.uint = index + offset;
+    uint64_t max_read = MIN((uint64_t)dev->profile.max_read_table, dev->resp_buf_size - OPAL_READ_TABLE_OVERHEAD);
+    uint64_t next = 0;
+    struct opal_stream stream = { 0 };
+
+    /* Gets are streamed like the Sets of opal_generic_write_table */
+    bool pending = false;
+    while (next < end_row || stream.count) {
+        if (next < end_row && !pending) {
+            opal_generic_read_table_cmd[3].val.uint = next + offset;
+
+            len = MIN(max_read, (end_row - next));
+            opal_generic_read_table_cmd[7].val.uint = next + offset + len;
 
-        len = MIN((uint64_t)OPAL_MAX_READ_TABLE, (end_row - index));
-        opal_generic_read_table_cmd[7].val.uint = index + offset + len;
+            prepare_req_buf(dev, opal_generic_read_table_cmd,
+                    ARRAY_SIZE(opal_generic_read_table_cmd),
+                    opal_uid[table],
+                    opal_method[OPAL_GET_METHOD_UID]);
+            pending = true;
+        }
+
+        if (pending && opal_stream_can_send(dev, &stream)) {
+            ret = opal_stream_send(fd, dev, &stream, next, len);
+            if (ret)
+                break;
 
-        prepare_req_buf(dev, opal_generic_read_table_cmd,
-                ARRAY_SIZE(opal_generic_read_table_cmd),
-                opal_uid[table],
-                opal_method[OPAL_GET_METHOD_UID]);
+            pending = false;
+            next += len;
+            continue;
+        }
 
-        ret = opal_snd_rcv_cmd_parse_chk(fd, dev, false);
+        ret = opal_stream_recv(fd, dev, &stream, &index);
         if (ret) {
             opal_put_all_tokens(dev->payload.tokens, &dev->payload.len);
             break;
@@ -2198,10 +2559,10 @@ static int opal_generic_read_table(int fd, struct opal_device *dev, enum opaluid
         memcpy(data + index, dev->payload.tokens[1]->pos + jmp, data_len);
 
         opal_put_all_tokens(dev->payload.tokens, &dev->payload.len);
-
-        index += len;
     }
 
+    opal_stream_drain(fd, dev, &stream);
+
     return ret;
 }
 
@@ -2238,18 +2599,35 @@ static int list_lr(int fd, struct opal_device *dev, struct sed_opal_locking_rang
 
     SEDCLI_DEBUG_PARAM("The number of ranges discovered is: %d\n", lrs->lr_num);
 
-    uint8_t uid[OPAL_UID_LENGTH];
-    for (uint8_t i = 0; i < lrs->lr_num; i++) {
-        build_gr_lr(uid, i);
+    uint64_t next = 0, index;
+    bool pending = false;
+    struct opal_stream stream = { 0 };
 
-        ret = opal_generic_get_column(fd, dev, uid, OPAL_RANGESTART, OPAL_WRITELOCKED);
+    /* The Gets are streamed like those of opal_generic_read_table */
+    while (next < lrs->lr_num || stream.count) {
+        if (next < lrs->lr_num && !pending) {
+            prepare_generic_get_column(dev, build_gr_lr(next), OPAL_RANGESTART, OPAL_WRITELOCKED);
+            pending = true;
+        }
+
+        if (pending && opal_stream_can_send(dev, &stream)) {
+            ret = opal_stream_send(fd, dev, &stream, next, 1);
+            if (ret)
+                break;
+
+            pending = false;
+            next++;
+            continue;
+        }
+
+        ret = opal_stream_recv(fd, dev, &stream, &index);
         if (ret) {
             opal_put_all_tokens(dev->payload.tokens, &dev->payload.len);
-            return ret;
+            break;
         }
 
-        struct sed_opal_locking_range *lr = &lrs->lrs[i];
-        lr->lr_id = i;
+        struct sed_opal_locking_range *lr = &lrs->lrs[index];
+        lr->lr_id = index;
         lr->start = dev->payload.tokens[4]->vals.uint;
         lr->length = dev->payload.tokens[8]->vals.uint;
         lr->rle = dev->payload.tokens[12]->vals.uint;
@@ -2260,6 +2638,8 @@ static int list_lr(int fd, struct opal_device *dev, struct sed_opal_locking_rang
         opal_put_all_tokens(dev->payload.tokens, &dev->payload.len);
     }
 
+    opal_stream_drain(fd, dev, &stream);
+
     return ret;
 }
 
@@ -2285,7 +2665,7 @@ static struct opal_req_item opal_genkey_pin_length_cmd[] = {
     { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_ENDNAME } },
 };
 
-int opal_genkey(struct opal_device *dev, int fd, uint8_t *uid, uint32_t public_exponent, uint32_t pin_length)
+int opal_genkey(struct opal_device *dev, int fd, sed_uid_t uid, uint32_t public_exponent, uint32_t pin_length)
 {
     size_t genkey_size = 0;
 
@@ -2352,16 +2732,11 @@ int opal_get_msid_pin_pt(struct sed_device *dev, struct sed_key *msid_pin)
 {
     memset(msid_pin, 0, sizeof(*msid_pin));
 
-    int ret = opal_start_generic_session(dev->fd, dev->priv, opal_uid[OPAL_ADMIN_SP_UID], opal_uid[OPAL_ANYBODY_UID], NULL);
-    if (ret)
-        goto end_session;
-
-    ret = opal_get_msid(dev->fd, dev->priv, msid_pin->key, &msid_pin->len);
-    if (ret)
-        goto end_session;
+    int ret = opal_start_read_session(dev->fd, dev->priv, opal_uid[OPAL_ADMIN_SP_UID]);
+    if (ret == 0)
+        ret = opal_get_msid(dev->fd, dev->priv, msid_pin->key, &msid_pin->len);
 
-end_session:
-    opal_end_session(dev->fd, dev->priv);
+    opal_end_read_session(dev->fd, dev->priv, ret);
 
     return ret;
 }
@@ -2399,8 +2774,8 @@ end_session:
     return ret;
 }
 
-int opal_revert_pt(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid,
-    uint8_t *target_sp_uid)
+int opal_revert_pt(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    sed_uid_t target_sp_uid)
 {
     if (dev == NULL || key == NULL) {
         SEDCLI_DEBUG_MSG("Must provide a password or a valid device\n");
@@ -2417,7 +2792,7 @@ int opal_revert_pt(struct sed_device *dev, const struct sed_key *key, uint8_t *s
         goto end_session;
     }
 
-    if (compare_uid(target_sp_uid, opal_uid[OPAL_ADMIN_SP_UID]))
+    if (target_sp_uid == opal_uid[OPAL_ADMIN_SP_UID])
         return ret;
 
 end_session:
@@ -2437,7 +2812,7 @@ static int parse_lr_str(char *item_str, uint32_t *item, size_t item_size, bool *
     } else {
         num = strtok(item_str, ",");
         while (num != NULL && count < item_size) {
-            uint8_t uid[OPAL_UID_LENGTH] = { 0 };
+            sed_uid_t uid = 0;
             uint id = 0;
             char *p = num;
             while (id < 8) {
@@ -2445,7 +2820,8 @@ static int parse_lr_str(char *item_str, uint32_t *item, size_t item_size, bool *
                 char byte[3] = { 0 };
                 memcpy(byte, p, sizeof(char) * 2);
                 byte[2] = 0;
-                uid[id++] = (int)strtoul(p, &errchk, 16);
+                uid = uid << 8 | (uint8_t)strtoul(p, &errchk, 16);
+                id++;
                 if (errchk == p) {
                     SEDCLI_DEBUG_MSG("Invalid hex number.\n");
                     return -EINVAL;
@@ -2456,25 +2832,16 @@ static int parse_lr_str(char *item_str, uint32_t *item, size_t item_size, bool *
             }
 
             uint32_t parsed = (uint32_t)-1;
-            if (!memcmp(uid, opal_uid[OPAL_LOCKINGRANGE_GLOBAL_UID], sizeof(uint8_t) * OPAL_UID_LENGTH))
+            if (uid == opal_uid[OPAL_LOCKINGRANGE_GLOBAL_UID])
                 parsed = 0;
-            else if (!memcmp(uid, opal_uid[OPAL_LOCKING_TABLE_UID], sizeof(uint8_t) * OPAL_UID_LENGTH)) {
+            else if (uid == opal_uid[OPAL_LOCKING_TABLE_UID]) {
                 parsed = 0;
                 *is_locking_table = true;
             }
-            else {
-                uint8_t user_lr[OPAL_UID_LENGTH];
-                memcpy(user_lr, opal_uid[OPAL_LOCKINGRANGE_GLOBAL_UID], OPAL_UID_LENGTH);
-                user_lr[5] = LOCKING_RANGE_NON_GLOBAL;
-
-                if (!memcmp(uid, user_lr, sizeof(uint8_t) * (OPAL_UID_LENGTH - 1)))
-                    parsed = uid[OPAL_UID_LENGTH - 1];
-                else {
-                    for (int i = 0; i < OPAL_UID_LENGTH; i++)
-                        item[i] = uid[i];
-                    return -EINVAL;
-                }
-            }
+            else if (uid >> 8 == build_gr_lr(1) >> 8)
+                parsed = uid_get_byte(uid, 7);
+            else
+                return -EINVAL;
 
             if (count < item_size) {
                 item[count] = parsed;
@@ -2533,8 +2900,8 @@ static int parse_dsts_str(char *item_str, uint32_t *item, size_t item_size)
     return num_lrs;
 }
 
-int opal_activate_sp_pt(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid,
-    uint8_t *target_sp_uid, char *lr_str, uint8_t range_start_length_policy, char *dsts_str)
+int opal_activate_sp_pt(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    sed_uid_t target_sp_uid, char *lr_str, uint8_t range_start_length_policy, char *dsts_str)
 {
     if (key == NULL) {
         SEDCLI_DEBUG_MSG("Must Provide a password.\n");
@@ -2569,7 +2936,7 @@ end_session:
     return ret;
 }
 
-int opal_revert_lsp_pt(struct sed_device *dev, const struct sed_key *key, uint8_t *auth_uid, bool keep_global_range_key)
+int opal_revert_lsp_pt(struct sed_device *dev, const struct sed_key *key, sed_uid_t auth_uid, bool keep_global_range_key)
 {
     if (key == NULL) {
         SEDCLI_DEBUG_MSG("Must Provide a password.\n");
@@ -2620,14 +2987,34 @@ end_session:
     return ret;
 }
 
-int opal_enable_user_pt(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid,
-    uint8_t *user_uid)
+int opal_enable_user_pt(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    sed_uid_t user_uid)
+{
+    return opal_enable_users_pt(dev, key, sp_uid, auth_uid, &user_uid, NULL, 1);
+}
+
+int opal_enable_users_pt(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    const sed_uid_t *user_uids, const struct sed_key *user_keys, uint8_t count)
 {
+    if (user_uids == NULL || count == 0)
+        return -EINVAL;
+
     int ret = opal_start_generic_session(dev->fd, dev->priv, sp_uid, auth_uid, key);
     if (ret)
         goto end_session;
 
-    ret = opal_enable_user(dev->fd, dev->priv, user_uid);
+    for (uint8_t i = 0; i < count && !ret; i++) {
+        ret = opal_enable_user(dev->fd, dev->priv, user_uids[i]);
+        if (ret || user_keys == NULL)
+            continue;
+
+        ret = opal_set_password(dev->fd, dev->priv, get_cpin_uid(user_uids[i]), &user_keys[i]);
+        if (ret)
+            continue;
+
+        /* Verify the new password by adding the user to this session */
+        ret = opal_authenticate_method(dev->fd, dev->priv, user_uids[i], &user_keys[i]);
+    }
 
 end_session:
     opal_end_session(dev->fd, dev->priv);
@@ -2635,8 +3022,8 @@ end_session:
     return ret;
 }
 
-int opal_setup_lr_pt(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid,
-    uint8_t *lr_uid, uint64_t range_start, uint64_t range_length, enum SED_FLAG_TYPE rle, enum SED_FLAG_TYPE wle)
+int opal_setup_lr_pt(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    sed_uid_t lr_uid, uint64_t range_start, uint64_t range_length, enum SED_FLAG_TYPE rle, enum SED_FLAG_TYPE wle)
 {
     if (range_start == (uint64_t)-1 || range_length == (uint64_t)-1 || key == NULL) {
         SEDCLI_DEBUG_MSG("Incorrect parameters, please try again\n");
@@ -2655,7 +3042,7 @@ end_session:
     return ret;
 }
 
-int opal_lock_unlock_pt(struct sed_device *dev, const struct sed_key *key, uint8_t *auth_uid, uint8_t lr, bool sum,
+int opal_lock_unlock_pt(struct sed_device *dev, const struct sed_key *key, sed_uid_t auth_uid, uint8_t lr, bool sum,
     enum SED_ACCESS_TYPE access_type)
 {
     if (access_type > SED_ACCESS_LK) {
@@ -2663,7 +3050,7 @@ int opal_lock_unlock_pt(struct sed_device *dev, const struct sed_key *key, uint8
         return -EINVAL;
     }
 
-    int ret = opal_start_auth_session(dev->fd, dev->priv, sum, lr, NULL, auth_uid, key);
+    int ret = opal_start_auth_session(dev->fd, dev->priv, sum, lr, 0, auth_uid, key);
     if (ret)
         goto end_session;
 
@@ -2678,52 +3065,14 @@ end_session:
     return ret;
 }
 
-int opal_set_password_pt(struct sed_device *dev, uint8_t *sp_uid, uint8_t *auth_uid, const struct sed_key *auth_key,
-    uint8_t *user_uid, const struct sed_key *new_user_key)
+int opal_set_password_pt(struct sed_device *dev, sed_uid_t sp_uid, sed_uid_t auth_uid, const struct sed_key *auth_key,
+    sed_uid_t user_uid, const struct sed_key *new_user_key)
 {
     int ret = opal_start_generic_session(dev->fd, dev->priv, sp_uid, auth_uid, auth_key);
     if (ret)
         goto end_session;
 
-    uint8_t uid[OPAL_UID_LENGTH] = { 0 };
-
-    if (compare_uid(user_uid, opal_uid[OPAL_SID_UID])) {
-        SEDCLI_DEBUG_MSG("Setting password for SID user.\n");
-        memcpy(&uid, opal_uid[OPAL_C_PIN_SID_UID], sizeof(uint8_t) * OPAL_UID_LENGTH);
-    }
-    else if(compare_uid_range(user_uid, opal_uid[OPAL_ADMIN1_UID], 1, 4)) {
-        SEDCLI_DEBUG_MSG("Setting password for admin user from locking sp table.\n");
-        memcpy(&uid, opal_uid[OPAL_C_PIN_LOCKING_SP_ADMIN1_UID], sizeof(uint8_t) * OPAL_UID_LENGTH);
-        // align last uid byte to given admin id from locking sp
-        uid[7] = user_uid[7];
-    } else if(compare_uid_range(user_uid, opal_uid[OPAL_USER1_UID], 1, 9)) {
-        SEDCLI_DEBUG_MSG("Setting password for user from locking sp table.\n");
-        memcpy(&uid, opal_uid[OPAL_C_PIN_USER1_UID], sizeof(uint8_t) * OPAL_UID_LENGTH);
-        // align last uid byte to given user id
-        uid[7] = user_uid[7];
-    } else if(compare_uid_range(user_uid, opal_uid[OPAL_ADMIN1_ADMIN_SP_UID], 1, 9)) {
-        SEDCLI_DEBUG_MSG("Setting password for admin from admin sp table.\n");
-        memcpy(&uid, opal_uid[OPAL_C_PIN_ADMIN_SP_ADMIN1_UID], sizeof(uint8_t) * OPAL_UID_LENGTH);
-        // align last uid byte to given admin id from admin sp
-        uid[7] = user_uid[7];
-    } else if (compare_uid(user_uid, opal_uid[OPAL_C_PIN_SID_UID])) {
-        SEDCLI_DEBUG_MSG("Setting password for SID with C_PIN table.\n");
-        memcpy(&uid, user_uid, sizeof(uint8_t) * OPAL_UID_LENGTH);
-    } else if(compare_uid_range(user_uid, opal_uid[OPAL_C_PIN_ADMIN_SP_ADMIN1_UID], 1, 4)) {
-        SEDCLI_DEBUG_MSG("Setting password for admin with C_PIN table from admin sp table.\n");
-        memcpy(&uid, user_uid, sizeof(uint8_t) * OPAL_UID_LENGTH);
-    } else if(compare_uid_range(user_uid, opal_uid[OPAL_C_PIN_LOCKING_SP_ADMIN1_UID], 1, 4)) {
-        SEDCLI_DEBUG_MSG("Setting password for admin with C_PIN table from locking sp table.\n");
-        memcpy(&uid, user_uid, sizeof(uint8_t) * OPAL_UID_LENGTH);
-    } else if(compare_uid_range(user_uid, opal_uid[OPAL_C_PIN_USER1_UID], 1, 4)) {
-        SEDCLI_DEBUG_MSG("Setting password for user with C_PIN table from locking sp table.\n");
-        memcpy(&uid, user_uid, sizeof(uint8_t) * OPAL_UID_LENGTH);
-    } else {
-        SEDCLI_DEBUG_MSG("Setting password - warning - user uid doesn't found.\n");
-        memcpy(&uid, user_uid, sizeof(uint8_t) * OPAL_UID_LENGTH);
-    }
-
-    ret = opal_set_password(dev->fd, dev->priv, uid, new_user_key);
+    ret = opal_set_password(dev->fd, dev->priv, get_cpin_uid(user_uid), new_user_key);
 
 end_session:
     opal_end_session(dev->fd, dev->priv);
@@ -2771,8 +3120,8 @@ end_session:
     return ret;
 }
 
-int opal_erase_pt(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid,
-    uint8_t *uid)
+int opal_erase_pt(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    sed_uid_t uid)
 {
     int ret = opal_start_generic_session(dev->fd, dev->priv, sp_uid, auth_uid, key);
     if (ret)
@@ -2799,6 +3148,16 @@ int opal_ds_read_pt(struct sed_device *dev, enum SED_AUTHORITY auth, const struc
     if (ret)
         return ret;
 
+    if (auth == SED_ANYBODY) {
+        ret = opal_start_read_session(dev->fd, dev->priv, opal_uid[OPAL_LOCKING_SP_UID]);
+        if (ret == 0)
+            ret = opal_read_datastore(dev->fd, dev->priv, to, offset, size);
+
+        opal_end_read_session(dev->fd, dev->priv, ret);
+
+        return ret;
+    }
+
     ret = opal_start_generic_session(dev->fd, dev->priv, opal_uid[OPAL_LOCKING_SP_UID], opal_uid[auth_id], key);
     if (ret)
         goto end_session;
@@ -2844,8 +3203,8 @@ static struct opal_req_item opal_ds_add_anybody_set_cmd[] = {
     { .type = OPAL_U8, .len = 1, .val = { .byte = 0x03 } }, /* BooleanExpr */
     { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_STARTLIST } },
     { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_STARTNAME } },
-    { .type = OPAL_BYTES, .len = 4, .val = { .bytes = opal_uid[OPAL_HALF_UID_AUTHORITY_OBJ_REF_UID] } },
-    { .type = OPAL_BYTES, .len = 8, .val = { .bytes = opal_uid[OPAL_ANYBODY_UID] } },
+    { .type = OPAL_HALF_UID, .len = 4, .val = { .uid = 0 } }, /* Authority object ref */
+    { .type = OPAL_UID, .len = 8, .val = { .uid = 0 } }, /* Anybody */
     { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_ENDNAME } },
     { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_ENDLIST } },
     { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_ENDNAME } },
@@ -2870,6 +3229,9 @@ int opal_ds_add_anybody_get_pt(struct sed_device *dev, const struct sed_key *key
     if (ret)
         goto end_session;
 
+    opal_ds_add_anybody_set_cmd[7].val.uid = opal_uid[OPAL_HALF_UID_AUTHORITY_OBJ_REF_UID];
+    opal_ds_add_anybody_set_cmd[8].val.uid = opal_uid[OPAL_ANYBODY_UID];
+
     prepare_req_buf(opal_dev, opal_ds_add_anybody_set_cmd, ARRAY_SIZE(opal_ds_add_anybody_set_cmd),
         opal_uid[OPAL_ACE_DS_GET_ALL_UID], opal_method[OPAL_SET_METHOD_UID]);
 
@@ -2926,6 +3288,16 @@ int opal_read_shadow_mbr_pt(struct sed_device *dev, enum SED_AUTHORITY auth, con
     if (ret)
         return ret;
 
+    if (auth == SED_ANYBODY) {
+        ret = opal_start_read_session(dev->fd, dev->priv, opal_uid[OPAL_LOCKING_SP_UID]);
+        if (ret == 0)
+            ret = opal_read_mbr(dev->fd, dev->priv, to, offset, size);
+
+        opal_end_read_session(dev->fd, dev->priv, ret);
+
+        return ret;
+    }
+
     ret = opal_start_generic_session(dev->fd, dev->priv, opal_uid[OPAL_LOCKING_SP_UID], opal_uid[auth_id], key);
     if (ret)
         goto end_session;
@@ -3007,7 +3379,7 @@ int opal_stack_reset_pt(struct sed_device *device, int32_t com_id, uint64_t exte
 
     int32_t dev_com_id = com_id != 0 ? com_id : dev->comid;
     int ret = opal_send_recv(device->fd, TCG_SECP_02, dev_com_id, dev->req_buf, STACK_RESET_PAYLOAD_SZ, dev->resp_buf,
-        STACK_RESET_PAYLOAD_SZ);
+        STACK_RESET_PAYLOAD_SZ, dev->profile.poll_interval);
     if (ret) {
         SEDCLI_DEBUG_PARAM("NVMe error during stack-reset: %d\n", ret);
         nvme_error = ret;
@@ -3031,7 +3403,7 @@ int opal_start_generic_session_pt(struct sed_device *device, const struct sed_ke
     return ret;
 }
 
-int opal_start_session_pt(struct sed_device *device, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid,
+int opal_start_session_pt(struct sed_device *device, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
     struct sed_session *session)
 {
     int ret = opal_start_generic_session(device->fd, device->priv, sp_uid, auth_uid, key);
@@ -3070,8 +3442,8 @@ int opal_start_end_transactions_pt(struct sed_device *dev, bool start, uint8_t s
     return opal_transactions(dev->fd, dev->priv, start, status);
 }
 
-int opal_genkey_pt(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid,
-    uint8_t *uid, uint32_t public_exponent, uint32_t pin_length)
+int opal_genkey_pt(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    sed_uid_t uid, uint32_t public_exponent, uint32_t pin_length)
 {
     int ret = opal_start_generic_session(dev->fd, dev->priv, sp_uid, auth_uid, key);
     if (ret)
@@ -3311,8 +3683,8 @@ error:
     return ret;
 }
 
-int opal_set_with_buf_pt(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid,
-    uint8_t *uid, struct opal_req_item *cmd, size_t cmd_len)
+int opal_set_with_buf_pt(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    sed_uid_t uid, struct opal_req_item *cmd, size_t cmd_len)
 {
     int ret = opal_start_generic_session(dev->fd, dev->priv, sp_uid, auth_uid, key);
     if (ret)
@@ -3326,14 +3698,28 @@ end_session:
     return ret;
 }
 
-int opal_get_set_col_val_pt(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid,
-    uint8_t *uid, uint64_t col, bool get, struct sed_opal_col_info *col_info)
+int opal_get_set_col_val_pt(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    sed_uid_t uid, uint64_t col, bool get, struct sed_opal_col_info *col_info)
 {
     if (!get && col_info->data == NULL) {
         SEDCLI_DEBUG_MSG("Must provide a valid data pointer to SET the column value\n");
         return -EINVAL;
     }
 
+    if (get && auth_uid == opal_uid[OPAL_ANYBODY_UID]) {
+        struct opal_device *opal_dev = dev->priv;
+        int ret = opal_start_read_session(dev->fd, opal_dev, sp_uid);
+        if (ret == 0)
+            ret = opal_generic_get_column(dev->fd, opal_dev, uid, col, col);
+        if (ret == 0)
+            ret = parse_col_value(opal_dev, col_info);
+
+        opal_put_all_tokens(opal_dev->payload.tokens, &opal_dev->payload.len);
+        opal_end_read_session(dev->fd, opal_dev, ret);
+
+        return ret;
+    }
+
     int ret = opal_start_generic_session(dev->fd, dev->priv, sp_uid, auth_uid, key);
     if (ret)
         goto end_session;
@@ -3354,7 +3740,7 @@ end_session:
 }
 
 int opal_get_set_byte_table_pt(struct sed_device *dev, const struct sed_key *key, const enum SED_SP_TYPE sp,
-    const char *user, uint8_t *uid, uint64_t start, uint64_t end, uint8_t *buffer, bool is_set)
+    const char *user, sed_uid_t uid, uint64_t start, uint64_t end, uint8_t *buffer, bool is_set)
 {
     if (buffer == NULL) {
         SEDCLI_DEBUG_MSG("Must provide a valid data pointer to buffer\n");
@@ -3366,8 +3752,8 @@ int opal_get_set_byte_table_pt(struct sed_device *dev, const struct sed_key *key
     if (ret)
         return ret;
 
-    uint8_t sp_uid[OPAL_UID_LENGTH];
-    ret = get_opal_sp_uid(sp, sp_uid);
+    sed_uid_t sp_uid;
+    ret = get_opal_sp_uid(sp, &sp_uid);
     if (ret)
         return ret;
 
@@ -3411,8 +3797,8 @@ int opal_tper_reset_pt(struct sed_device *dev)
     return ret;
 }
 
-int opal_reactivate_sp_pt(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid,
-    uint8_t *target_sp_uid, char *lr_str, uint8_t range_start_length_policy, const struct sed_key *admin1_pwd, char *dsts_str)
+int opal_reactivate_sp_pt(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    sed_uid_t target_sp_uid, char *lr_str, uint8_t range_start_length_policy, const struct sed_key *admin1_pwd, char *dsts_str)
 {
     if (key == NULL) {
         SEDCLI_DEBUG_MSG("Must Provide a password.\n");
@@ -3495,7 +3881,7 @@ static int opal_assign(int fd, struct opal_device *dev, uint32_t nsid, uint8_t r
 
     /* Send the LO uid back to the user for deassign operation */
     int jmp = get_payload_string(dev, 1);
-    memcpy(info->uid, dev->payload.tokens[1]->pos + jmp, 8);
+    info->uid = uid_from_bytes(dev->payload.tokens[1]->pos + jmp);
     info->nsid = nsid;
     info->nsgid = dev->payload.tokens[2]->vals.uint;
 
@@ -3504,7 +3890,7 @@ static int opal_assign(int fd, struct opal_device *dev, uint32_t nsid, uint8_t r
     return ret;
 }
 
-int opal_assign_pt(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid,
+int opal_assign_pt(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
     uint32_t nsid, uint8_t range_start, uint8_t range_len, struct sed_locking_object *info)
 {
     int ret = opal_start_generic_session(dev->fd, dev->priv, sp_uid, auth_uid, key);
@@ -3522,12 +3908,12 @@ end_session:
 }
 
 static struct opal_req_item deassign_cmd[] = {
-    { .type = OPAL_BYTES, .len = 8, .val = { .bytes = NULL } }, /* LO UID */
+    { .type = OPAL_UID, .len = 8, .val = { .uid = 0 } }, /* LO UID */
 };
 
-static int opal_deassign(int fd, struct opal_device *dev, const uint8_t *uid, bool keep_ns_global_range_key)
+static int opal_deassign(int fd, struct opal_device *dev, sed_uid_t uid, bool keep_ns_global_range_key)
 {
-    deassign_cmd[0].val.bytes = uid;
+    deassign_cmd[0].val.uid = uid;
 
     prepare_req_buf(dev, deassign_cmd, ARRAY_SIZE(deassign_cmd), opal_uid[OPAL_LOCKING_TABLE_UID],
         opal_method[OPAL_DEASSIGN_METHOD_UID]);
@@ -3541,8 +3927,8 @@ static int opal_deassign(int fd, struct opal_device *dev, const uint8_t *uid, bo
     return ret;
 }
 
-int opal_deassign_pt(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid,
-    const uint8_t *uid, bool keep_ns_global_range_key)
+int opal_deassign_pt(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    sed_uid_t uid, bool keep_ns_global_range_key)
 {
     int ret = opal_start_generic_session(dev->fd, dev->priv, sp_uid, auth_uid, key);
     if (ret)
@@ -3556,48 +3942,45 @@ end_session:
     return ret;
 }
 
+/*
+ * Collect the UIDs of a Next or GetACL response into one contiguous array.
+ * The array of a previous call is reused and only grows when the response
+ * holds more UIDs than it did.
+ */
 static int parse_next_uids(struct opal_device *dev, struct sed_next_uids *next_uids)
 {
-    size_t size = 0;
-    next_uids->uids = (uint8_t **)malloc(sizeof(uint8_t *) * (size + 1));
-    if (next_uids->uids == NULL)
-        return -ENOMEM;
-
+    uint32_t size = 0;
     for (uint32_t i = 0; i < dev->payload.len; i++) {
-        if (dev->payload.tokens[i]->type == OPAL_DTA_TOKENID_BYTESTRING) {
-            next_uids->uids = (uint8_t **)realloc(next_uids->uids, sizeof(uint8_t*) * (size + 1));
-            if (next_uids->uids == NULL)
-                goto deinit;
+        if (dev->payload.tokens[i]->type == OPAL_DTA_TOKENID_BYTESTRING)
+            size++;
+    }
 
-            next_uids->uids[size] = (uint8_t *)calloc(OPAL_UID_LENGTH, sizeof(uint8_t));
-            if (next_uids->uids[size] == NULL)
-                goto deinit;
+    if (size > next_uids->capacity) {
+        sed_uid_t *uids = realloc(next_uids->uids, sizeof(*uids) * size);
+        if (uids == NULL)
+            return -ENOMEM;
 
-            int jmp = get_payload_string(dev, i);
-            memcpy(next_uids->uids[size], dev->payload.tokens[i]->pos + jmp, OPAL_UID_LENGTH);
+        next_uids->uids = uids;
+        next_uids->capacity = size;
+    }
 
-            size++;
+    size = 0;
+    for (uint32_t i = 0; i < dev->payload.len; i++) {
+        if (dev->payload.tokens[i]->type == OPAL_DTA_TOKENID_BYTESTRING) {
+            int jmp = get_payload_string(dev, i);
+            next_uids->uids[size++] = uid_from_bytes(dev->payload.tokens[i]->pos + jmp);
         }
     }
 
     next_uids->size = size;
 
     return SED_SUCCESS;
-
-deinit:
-    if (next_uids->uids) {
-        for (uint16_t i = 0; i < next_uids->size; i++)
-            free(next_uids->uids[i]);
-        free(next_uids->uids);
-    }
-
-    return -ENOMEM;
 }
 
 static struct opal_req_item table_next_cmd_where[] = {
     { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_STARTNAME } },
     { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_WHERE } },
-    { .type = OPAL_BYTES, .len = 0, .val = { .bytes = NULL } }, // where
+    { .type = OPAL_UID, .len = 8, .val = { .uid = 0 } }, // where
     { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_ENDNAME } }
 };
 
@@ -3608,15 +3991,14 @@ static struct opal_req_item table_next_cmd_count[] = {
     { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_ENDNAME } }
 };
 
-static int opal_table_next(int fd, struct opal_device *dev, uint8_t *uid, uint8_t *where, uint16_t count,
+static int opal_table_next(int fd, struct opal_device *dev, sed_uid_t uid, sed_uid_t where, uint16_t count,
     struct sed_next_uids *next_uids)
 {
     struct opal_req_item table_next_cmd[8] = { 0 };
     uint8_t size = 0;
 
     if (where) {
-        table_next_cmd_where[2].val.bytes = where;
-        table_next_cmd_where[2].len = 8;
+        table_next_cmd_where[2].val.uid = where;
         memcpy(table_next_cmd, table_next_cmd_where, sizeof(struct opal_req_item) * 4);
         size += 4;
     }
@@ -3643,8 +4025,8 @@ put_tokens:
     return ret;
 }
 
-int opal_table_next_pt(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid,
-    uint8_t *uid, uint8_t *where, uint16_t count, struct sed_next_uids *next_uids)
+int opal_table_next_pt(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    sed_uid_t uid, sed_uid_t where, uint16_t count, struct sed_next_uids *next_uids)
 {
     int ret = opal_start_generic_session(dev->fd, dev->priv, sp_uid, auth_uid, key);
     if (ret)
@@ -3658,32 +4040,60 @@ end_session:
     return ret;
 }
 
-static struct opal_req_item authenticate_cmd[] = {
-    { .type = OPAL_BYTES, .len = 8, .val = { .bytes = NULL } }, // Auth UID
+int opal_table_iter_start_pt(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    sed_uid_t uid, uint16_t count, struct sed_table_iter *iter)
+{
+    memset(iter, 0, sizeof(*iter));
+    iter->uid = uid;
+    iter->count = count;
 
-    { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_STARTNAME } },
-    { .type = OPAL_U8, .len = 1, .val = { .byte = 0 } },
-    { .type = OPAL_BYTES, .len = 1, .val = { .bytes = NULL } }, // Proof / Host Challenge
-    { .type = OPAL_U8, .len = 1, .val = { .byte = OPAL_ENDNAME } },
-};
+    int ret = opal_start_generic_session(dev->fd, dev->priv, sp_uid, auth_uid, key);
+    if (ret)
+        opal_end_session(dev->fd, dev->priv);
 
-int opal_authenticate_method(int fd, struct opal_device *dev, int auth, const struct sed_key *key)
+    return ret;
+}
+
+int opal_table_iter_next_pt(struct sed_device *dev, struct sed_table_iter *iter)
 {
-    /* New authority UID */
-    authenticate_cmd[0].val.bytes = opal_uid[auth];
+    if (iter->done) {
+        iter->page.size = 0;
+        return SED_SUCCESS;
+    }
 
-    /* Proof/Host Challenge */
-    authenticate_cmd[3].val.bytes = (uint8_t *)key->key;
-    authenticate_cmd[3].len = key->len;
+    int ret = opal_table_next(dev->fd, dev->priv, iter->uid, iter->where, iter->count, &iter->page);
+    if (ret)
+        return ret;
 
-    prepare_req_buf(dev, authenticate_cmd, ARRAY_SIZE(authenticate_cmd), opal_uid[OPAL_THIS_SP_UID],
-        opal_method[OPAL_AUTHENTICATE_METHOD_UID]);
+    /*
+     * The TPer may return fewer rows than asked for to fit its ComPacket
+     * size, only an empty page marks the end of the table
+     */
+    if (iter->page.size == 0) {
+        iter->done = true;
+        return SED_SUCCESS;
+    }
 
-    int ret = opal_snd_rcv_cmd_parse_chk(fd, dev, false);
+    /* A page that doesn't move past where would be fetched forever */
+    sed_uid_t last = iter->page.uids[iter->page.size - 1];
+    if (last == iter->where) {
+        SEDCLI_DEBUG_MSG("Next didn't advance past the last row returned\n");
+        iter->done = true;
+        iter->page.size = 0;
+        return -EIO;
+    }
 
-    opal_put_all_tokens(dev->payload.tokens, &dev->payload.len);
+    iter->where = last;
 
-    return ret;
+    return SED_SUCCESS;
+}
+
+int opal_table_iter_end_pt(struct sed_device *dev, struct sed_table_iter *iter)
+{
+    free(iter->page.uids);
+    memset(&iter->page, 0, sizeof(iter->page));
+
+    return opal_end_session(dev->fd, dev->priv);
 }
 
 int opal_authenticate_pt(struct sed_device *dev, enum SED_AUTHORITY auth, const struct sed_key *key)
@@ -3693,19 +4103,54 @@ int opal_authenticate_pt(struct sed_device *dev, enum SED_AUTHORITY auth, const
     if (ret)
         return ret;
 
-    return opal_authenticate_method(dev->fd, dev->priv, auth_id, key);;
+    return opal_authenticate_method(dev->fd, dev->priv, opal_uid[auth_id], key);
+}
+
+int opal_session_authenticate_pt(struct sed_device *device, struct sed_session *session, sed_uid_t auth_uid,
+    const struct sed_key *key)
+{
+    if (key == NULL) {
+        SEDCLI_DEBUG_MSG("Must provide password for this authority.\n");
+        return -EINVAL;
+    }
+
+    struct opal_device *dev = device->priv;
+
+    /* A warm read-only session can never gain write rights, don't add to it */
+    opal_close_read_session(device->fd, dev);
+    if (session == NULL && dev->session.hsn == 0 && dev->session.tsn == 0) {
+        SEDCLI_DEBUG_MSG("No session open to authenticate in.\n");
+        return -EINVAL;
+    }
+
+    uint32_t hsn = dev->session.hsn, tsn = dev->session.tsn;
+
+    /* The session may have been started by another process */
+    if (session) {
+        dev->session.hsn = session->hsn;
+        dev->session.tsn = session->tsn;
+    }
+
+    int ret = opal_authenticate_method(device->fd, dev, auth_uid, key);
+
+    if (session) {
+        dev->session.hsn = hsn;
+        dev->session.tsn = tsn;
+    }
+
+    return ret;
 }
 
 static struct opal_req_item get_acl_cmd[] = {
-    { .type = OPAL_BYTES, .len = 8, .val = { .bytes = NULL } }, // INVOKING UID
-    { .type = OPAL_BYTES, .len = 8, .val = { .bytes = NULL } }, // METHOD UID
+    { .type = OPAL_UID, .len = 8, .val = { .uid = 0 } }, // INVOKING UID
+    { .type = OPAL_UID, .len = 8, .val = { .uid = 0 } }, // METHOD UID
 };
 
-int opal_get_acl(int fd, struct opal_device *dev, const uint8_t *invoking_uid, const uint8_t *method_uid,
+int opal_get_acl(int fd, struct opal_device *dev, sed_uid_t invoking_uid, sed_uid_t method_uid,
     struct sed_next_uids *next_uids)
 {
-    get_acl_cmd[0].val.bytes = invoking_uid;
-    get_acl_cmd[1].val.bytes = method_uid;
+    get_acl_cmd[0].val.uid = invoking_uid;
+    get_acl_cmd[1].val.uid = method_uid;
 
     prepare_req_buf(dev, get_acl_cmd, ARRAY_SIZE(get_acl_cmd), opal_uid[OPAL_ACCESS_CONTROL_UID],
         opal_method[OPAL_GETACL_METHOD_UID]);
@@ -3721,8 +4166,8 @@ int opal_get_acl(int fd, struct opal_device *dev, const uint8_t *invoking_uid, c
     return ret;
 }
 
-int opal_get_acl_pt(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid,
-    const uint8_t *invoking_uid, const uint8_t *method_uid, struct sed_next_uids *next_uids)
+int opal_get_acl_pt(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    sed_uid_t invoking_uid, sed_uid_t method_uid, struct sed_next_uids *next_uids)
 {
     int ret = opal_start_generic_session(dev->fd, dev->priv, sp_uid, auth_uid, key);
     if (ret)
@@ -3735,3 +4180,77 @@ end_session:
 
     return ret;
 }
+
+int opal_get_profile_pt(struct sed_device *dev, struct sed_profile *profile)
+{
+    if (dev == NULL || profile == NULL)
+        return -EINVAL;
+
+    struct opal_device *opal_dev = dev->priv;
+    memcpy(profile, &opal_dev->profile, sizeof(*profile));
+
+    return SED_SUCCESS;
+}
+
+#define TUNE_ROUNDS            16
+#define TUNE_MIN_POLL_INTERVAL 100
+
+int opal_tune_profile_pt(struct sed_device *dev, struct sed_profile *profile, bool store)
+{
+    if (dev == NULL || profile == NULL)
+        return -EINVAL;
+
+    struct opal_device *opal_dev = dev->priv;
+    struct sed_profile tuned = opal_dev->profile;
+    struct timespec start, end;
+
+    /*
+     * Properties doesn't change any TPer state, so it is safe to repeat it
+     * to measure TPer turnaround. Poll fast meanwhile, otherwise the sleep
+     * between IF-RECVs would be measured instead of the TPer.
+     */
+    opal_dev->profile.poll_interval = TUNE_MIN_POLL_INTERVAL;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int ret = 0;
+    for (uint8_t i = 0; i < TUNE_ROUNDS && ret == 0; i++)
+        ret = opal_host_prop(dev, NULL, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    opal_dev->profile.poll_interval = tuned.poll_interval;
+    if (ret) {
+        SEDCLI_DEBUG_PARAM("Error measuring TPer turnaround: %d\n", ret);
+        return ret;
+    }
+
+    uint64_t turnaround = ((end.tv_sec - start.tv_sec) * 1000000 + (end.tv_nsec - start.tv_nsec) / 1000) / TUNE_ROUNDS;
+    tuned.poll_interval = MIN(turnaround / 2, (uint64_t)NVME_PROFILE_DEF_POLL_INTERVAL);
+    if (tuned.poll_interval < TUNE_MIN_POLL_INTERVAL)
+        tuned.poll_interval = TUNE_MIN_POLL_INTERVAL;
+
+    uint64_t max_com_pkt_sz = 0;
+    ret = tper_prop_to_val(dev, "MaxComPacketSize", &max_com_pkt_sz);
+    if (ret)
+        return ret;
+
+    if (max_com_pkt_sz <= OPAL_READ_TABLE_OVERHEAD)
+        return -EINVAL;
+
+    if (max_com_pkt_sz > NVME_PROFILE_DEF_MIN_IO_BUF_LEN)
+        tuned.min_io_buf_len = max_com_pkt_sz;
+    tuned.max_read_table = max_com_pkt_sz - OPAL_READ_TABLE_OVERHEAD;
+
+    uint64_t max_ind_token_sz = 0;
+    if (tper_prop_to_val(dev, "MaxIndTokenSize", &max_ind_token_sz) == SED_SUCCESS && max_ind_token_sz > 4)
+        tuned.max_read_table = MIN((uint64_t)tuned.max_read_table, max_ind_token_sz - 4); /* long atom header */
+
+    SEDCLI_DEBUG_PARAM("TPer turnaround %lu us, MaxComPacketSize %lu\n", turnaround, max_com_pkt_sz);
+
+    opal_dev->profile = tuned;
+    memcpy(profile, &tuned, sizeof(*profile));
+
+    if (store)
+        ret = nvme_profile_store(&opal_dev->profile_id, &tuned);
+
+    return ret;
+}
@@ -461,9 +461,15 @@ int opal_host_prop_pt(struct sed_device *dev, const char *props, uint32_t *vals)
 
 int opal_dev_discovery_pt(struct sed_device *dev, struct sed_opal_device_discovery *discovery);
 
+/*
+ * Re-run Level 0 discovery to update the features cached in dev, e.g. the
+ * Locked and MBRDone bits after they were changed through dev.
+ */
+int opal_refresh_discovery_pt(struct sed_device *dev);
+
 int opal_parse_tper_state_pt(struct sed_device *dev, struct sed_tper_state *tper_state);
 
-int opal_start_session_pt(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid, struct sed_session *session);
+int opal_start_session_pt(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid, struct sed_session *session);
 
 int opal_end_session_pt(struct sed_device *dev, struct sed_session *session);
 
@@ -473,29 +479,32 @@ int opal_take_ownership_pt(struct sed_device *dev, const struct sed_key *key);
 
 int opal_get_msid_pin_pt(struct sed_device *dev, struct sed_key *msid_pin);
 
-int opal_revert_pt(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid, uint8_t *target_sp_uid);
+int opal_revert_pt(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid, sed_uid_t target_sp_uid);
 
-int opal_revert_lsp_pt(struct sed_device *dev, const struct sed_key *key, uint8_t *auth_uid, bool keep_global_range_key);
+int opal_revert_lsp_pt(struct sed_device *dev, const struct sed_key *key, sed_uid_t auth_uid, bool keep_global_range_key);
 
-int opal_activate_sp_pt(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid,
-    uint8_t *target_sp_uid, char *lr_str, uint8_t range_start_length_policy, char *dsts_str);
+int opal_activate_sp_pt(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    sed_uid_t target_sp_uid, char *lr_str, uint8_t range_start_length_policy, char *dsts_str);
 
 int opal_add_user_to_lr_pt(struct sed_device *dev, const struct sed_key *key, const char *user,
     enum SED_ACCESS_TYPE access_type, uint8_t lr);
 
-int opal_enable_user_pt(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid, uint8_t *user_uid);
+int opal_enable_user_pt(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid, sed_uid_t user_uid);
+
+int opal_enable_users_pt(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    const sed_uid_t *user_uids, const struct sed_key *user_keys, uint8_t count);
 
 int opal_setup_global_range_pt(struct sed_device *dev, const struct sed_key *key, enum SED_FLAG_TYPE rle,
     enum SED_FLAG_TYPE wle);
 
-int opal_setup_lr_pt(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid, uint8_t *lr_uid,
+int opal_setup_lr_pt(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid, sed_uid_t lr_uid,
     uint64_t range_start, uint64_t range_length, enum SED_FLAG_TYPE rle, enum SED_FLAG_TYPE wle);
 
-int opal_lock_unlock_pt(struct sed_device *dev, const struct sed_key *key, uint8_t *auth_uid, uint8_t lr, bool sum,
+int opal_lock_unlock_pt(struct sed_device *dev, const struct sed_key *key, sed_uid_t auth_uid, uint8_t lr, bool sum,
     enum SED_ACCESS_TYPE access_type);
 
-int opal_set_password_pt(struct sed_device *dev, uint8_t *sp_uid, uint8_t *auth_uid, const struct sed_key *auth_key,
-    uint8_t *user_uid, const struct sed_key *new_user_key);
+int opal_set_password_pt(struct sed_device *dev, sed_uid_t sp_uid, sed_uid_t auth_uid, const struct sed_key *auth_key,
+    sed_uid_t user_uid, const struct sed_key *new_user_key);
 
 int opal_mbr_done_pt(struct sed_device *dev, const struct sed_key *key, bool mbr_done);
 
@@ -507,10 +516,10 @@ int opal_read_shadow_mbr_pt(struct sed_device *dev, enum SED_AUTHORITY auth, con
 int opal_write_shadow_mbr_pt(struct sed_device *dev, const struct sed_key *key, const uint8_t *from, uint32_t size,
     uint32_t offset);
 
-int opal_erase_pt(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid, uint8_t *uid);
+int opal_erase_pt(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid, sed_uid_t uid);
 
-int opal_genkey_pt(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid,
-    uint8_t *uid, uint32_t public_exponent, uint32_t pin_length);
+int opal_genkey_pt(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    sed_uid_t uid, uint32_t public_exponent, uint32_t pin_length);
 
 int opal_ds_read_pt(struct sed_device *, enum SED_AUTHORITY, const struct sed_key *, uint8_t *to, uint32_t size,
     uint32_t offset);
@@ -526,34 +535,48 @@ int opal_block_sid_pt(struct sed_device *dev, bool hw_reset);
 
 int opal_stack_reset_pt(struct sed_device *device, int32_t com_id, uint64_t extended_com_id, uint8_t *response);
 
-int opal_set_with_buf_pt(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid,
-    uint8_t *uid, struct opal_req_item *cmd, size_t cmd_len);
+int opal_set_with_buf_pt(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    sed_uid_t uid, struct opal_req_item *cmd, size_t cmd_len);
 
-int opal_get_set_col_val_pt(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid,
-    uint8_t *uid, uint64_t col, bool get, struct sed_opal_col_info *col_info);
+int opal_get_set_col_val_pt(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    sed_uid_t uid, uint64_t col, bool get, struct sed_opal_col_info *col_info);
 
 int opal_get_set_byte_table_pt(struct sed_device *dev, const struct sed_key *key, const enum SED_SP_TYPE sp,
-    const char *user, uint8_t *uid, uint64_t start, uint64_t end, uint8_t *buffer, bool is_set);
+    const char *user, sed_uid_t uid, uint64_t start, uint64_t end, uint8_t *buffer, bool is_set);
 
 int opal_tper_reset_pt(struct sed_device *dev);
 
-int opal_reactivate_sp_pt(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid,
-    uint8_t *target_sp_uid, char *lr_str, uint8_t range_start_length_policy, const struct sed_key *admin1_pwd,
+int opal_reactivate_sp_pt(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    sed_uid_t target_sp_uid, char *lr_str, uint8_t range_start_length_policy, const struct sed_key *admin1_pwd,
     char *dsts_str);
 
-int opal_assign_pt(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid,
+int opal_assign_pt(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
     uint32_t nsid, uint8_t range_start, uint8_t range_len, struct sed_locking_object *info);
 
-int opal_deassign_pt(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid,
-    const uint8_t *uid, bool keep_ns_global_range_key);
+int opal_deassign_pt(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    sed_uid_t uid, bool keep_ns_global_range_key);
 
-int opal_table_next_pt(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid,
-    uint8_t *uid, uint8_t *where, uint16_t count, struct sed_next_uids *next_uids);
+int opal_table_next_pt(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    sed_uid_t uid, sed_uid_t where, uint16_t count, struct sed_next_uids *next_uids);
 
 int opal_authenticate_pt(struct sed_device *dev, enum SED_AUTHORITY auth, const struct sed_key *key);
 
-int opal_get_acl_pt(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid,
-    const uint8_t *invoking_uid, const uint8_t *method_uid, struct sed_next_uids *next_uids);
+int opal_session_authenticate_pt(struct sed_device *device, struct sed_session *session, sed_uid_t auth_uid,
+    const struct sed_key *key);
+
+int opal_get_acl_pt(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    sed_uid_t invoking_uid, sed_uid_t method_uid, struct sed_next_uids *next_uids);
+
+int opal_table_iter_start_pt(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    sed_uid_t uid, uint16_t count, struct sed_table_iter *iter);
+
+int opal_table_iter_next_pt(struct sed_device *dev, struct sed_table_iter *iter);
+
+int opal_table_iter_end_pt(struct sed_device *dev, struct sed_table_iter *iter);
+
+int opal_get_profile_pt(struct sed_device *dev, struct sed_profile *profile);
+
+int opal_tune_profile_pt(struct sed_device *dev, struct sed_profile *profile, bool store);
 
 void opal_deinit_pt(struct sed_device *dev);
 
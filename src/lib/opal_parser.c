@@ -10,6 +10,9 @@
 #include <string.h>
 #include <errno.h>
 #include <assert.h>
+#include <endian.h>
+
+#include <libsed.h>
 
 #include "opal_parser.h"
 #include "sedcli_log.h"
@@ -204,6 +207,32 @@ int append_bytes(uint8_t *buf, size_t len, const uint8_t *src, size_t src_len)
     return ret;
 }
 
+/* UIDs always fit into a short atom, the bytes go in with a single store */
+int append_uid(uint8_t *buf, size_t len, sed_uid_t uid)
+{
+    if (len < OPAL_UID_LENGTH + 1)
+        return 0;
+
+    uint64_t val = htobe64(uid);
+    int ret = append_short_atom_bytes_header(buf, len, sizeof(val));
+    memcpy(buf + ret, &val, sizeof(val));
+
+    return ret + sizeof(val);
+}
+
+/* Half UIDs are made of the first four bytes of the UID */
+int append_half_uid(uint8_t *buf, size_t len, sed_uid_t uid)
+{
+    if (len < OPAL_UID_LENGTH / 2 + 1)
+        return 0;
+
+    uint32_t val = htobe32(uid >> 32);
+    int ret = append_short_atom_bytes_header(buf, len, sizeof(val));
+    memcpy(buf + ret, &val, sizeof(val));
+
+    return ret + sizeof(val);
+}
+
 static void parse_tiny_token(struct opal_token *token, uint8_t curr_byte)
 {
     token->width = OPAL_WIDTH_TINY;
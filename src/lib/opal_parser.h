@@ -32,6 +32,8 @@
 #define OPAL_U8 (1)
 #define OPAL_U64 (2)
 #define OPAL_BYTES (3)
+#define OPAL_UID (4)
+#define OPAL_HALF_UID (5)
 
 enum opal_atom_width {
     OPAL_WIDTH_TINY,
@@ -96,6 +98,8 @@ void opal_parser_deinit(void);
 int append_u8(uint8_t *buf, size_t len, uint8_t val);
 int append_u64(uint8_t *buf, size_t len, uint64_t val);
 int append_bytes(uint8_t *buf, size_t len, const uint8_t *src, size_t src_len);
+int append_uid(uint8_t *buf, size_t len, sed_uid_t uid);
+int append_half_uid(uint8_t *buf, size_t len, sed_uid_t uid);
 
 int opal_parse_data_payload(uint8_t *buf, size_t len, struct opal_parsed_payload *payload);
 void opal_put_all_tokens(struct opal_token **tokens, size_t *len);
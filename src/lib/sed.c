@@ -6,11 +6,14 @@
 
 #include <libsed.h>
 #include <errno.h>
+#include <stdlib.h>
 #include <string.h>
 #include <limits.h>
+#include <time.h>
 #include <linux/version.h>
 
 #include "nvme_pt_ioctl.h"
+#include "sed_state.h"
 #include "sed_util.h"
 #include "sedcli_log.h"
 
@@ -18,31 +21,42 @@
 #define NVME_DEV_PREFIX "nvme"
 #define PATH_MAX 4096
 
+/* Runs an operation and records its status and latency for the state table */
+#define SED_OP(dev, op) \
+   ({ uint64_t _start = now_us(); \
+      int _ret = (op); \
+      (dev)->state.last_error = _ret; \
+      (dev)->state.last_op_latency = now_us() - _start; \
+      _ret; })
+
 typedef int (*init)(struct sed_device *, const char *, bool);
 typedef int (*host_prop)(struct sed_device *, const char *, uint32_t *);
 typedef int (*dev_discovery)(struct sed_device *, struct sed_opal_device_discovery *);
+typedef int (*refresh_discovery)(struct sed_device *);
 typedef int (*parse_tper_state)(struct sed_device *, struct sed_tper_state *);
 typedef int (*take_ownership)(struct sed_device *, const struct sed_key *);
 typedef int (*get_msid_pin)(struct sed_device *, struct sed_key *);
-typedef int (*revert)(struct sed_device *, const struct sed_key *, uint8_t *, uint8_t *, uint8_t *);
-typedef int (*revert_lsp)(struct sed_device *, const struct sed_key *, uint8_t *, bool);
- typedef int (*activate_sp)(struct sed_device *, const struct sed_key *, uint8_t *, uint8_t *, uint8_t *, char *,
+typedef int (*revert)(struct sed_device *, const struct sed_key *, sed_uid_t, sed_uid_t, sed_uid_t);
+typedef int (*revert_lsp)(struct sed_device *, const struct sed_key *, sed_uid_t, bool);
+ typedef int (*activate_sp)(struct sed_device *, const struct sed_key *, sed_uid_t, sed_uid_t, sed_uid_t, char *,
     uint8_t, char *);
 typedef int (*setup_global_range)(struct sed_device *, const struct sed_key *, enum SED_FLAG_TYPE, enum SED_FLAG_TYPE);
 typedef int (*add_user_to_lr)(struct sed_device *, const struct sed_key *, const char *, enum SED_ACCESS_TYPE, uint8_t);
-typedef int (*enable_user)(struct sed_device *, const struct sed_key *, uint8_t *, uint8_t *, uint8_t *);
-typedef int (*setup_lr)(struct sed_device *, const struct sed_key *, uint8_t *, uint8_t *, uint8_t *, uint64_t, uint64_t,
+typedef int (*enable_user)(struct sed_device *, const struct sed_key *, sed_uid_t, sed_uid_t, sed_uid_t);
+typedef int (*enable_users)(struct sed_device *, const struct sed_key *, sed_uid_t, sed_uid_t, const sed_uid_t *,
+    const struct sed_key *, uint8_t);
+typedef int (*setup_lr)(struct sed_device *, const struct sed_key *, sed_uid_t, sed_uid_t, sed_uid_t, uint64_t, uint64_t,
     enum SED_FLAG_TYPE, enum SED_FLAG_TYPE);
-typedef int (*lock_unlock)(struct sed_device *, const struct sed_key *, uint8_t *, uint8_t, bool, enum SED_ACCESS_TYPE);
-typedef int (*set_password)(struct sed_device *, uint8_t *, uint8_t *, const struct sed_key *, uint8_t *,
+typedef int (*lock_unlock)(struct sed_device *, const struct sed_key *, sed_uid_t, uint8_t, bool, enum SED_ACCESS_TYPE);
+typedef int (*set_password)(struct sed_device *, sed_uid_t, sed_uid_t, const struct sed_key *, sed_uid_t,
     const struct sed_key *);
 typedef int (*shadow_mbr)(struct sed_device *, const struct sed_key *, bool);
 typedef int (*mbr_done) (struct sed_device *, const struct sed_key *, bool);
 typedef int (*read_shadow_mbr) (struct sed_device *, enum SED_AUTHORITY, const struct sed_key *, uint8_t *, uint32_t,
     uint32_t);
 typedef int (*write_shadow_mbr)(struct sed_device *, const struct sed_key *, const uint8_t *, uint32_t, uint32_t);
-typedef int (*erase)(struct sed_device *, const struct sed_key *, uint8_t *, uint8_t *, uint8_t *);
-typedef int (*genkey) (struct sed_device *, const struct sed_key *, uint8_t *, uint8_t *, uint8_t *,
+typedef int (*erase)(struct sed_device *, const struct sed_key *, sed_uid_t, sed_uid_t, sed_uid_t);
+typedef int (*genkey) (struct sed_device *, const struct sed_key *, sed_uid_t, sed_uid_t, sed_uid_t,
     uint32_t, uint32_t);
 typedef int (*ds_add_anybody_get)(struct sed_device *, const struct sed_key *);
 typedef int (*ds_read)(struct sed_device *, enum SED_AUTHORITY, const struct sed_key *, uint8_t *, uint32_t, uint32_t);
@@ -51,27 +65,34 @@ typedef int (*ds_write)(struct sed_device *, enum SED_AUTHORITY, const struct se
 typedef int (*list_lr)(struct sed_device *, const struct sed_key *, struct sed_opal_locking_ranges *);
 typedef int (*block_sid)(struct sed_device *, bool);
 typedef int (*stack_reset)(struct sed_device *, int32_t com_id, uint64_t extended_com_id, uint8_t *response);
-typedef int (*start_session)(struct sed_device *, const struct sed_key *, uint8_t *, uint8_t *, struct sed_session *);
+typedef int (*start_session)(struct sed_device *, const struct sed_key *, sed_uid_t, sed_uid_t, struct sed_session *);
 typedef int (*end_session)(struct sed_device *, struct sed_session *);
 typedef int (*start_end_transactions)(struct sed_device *, bool, uint8_t);
-typedef int (*set_with_buf)(struct sed_device *, const struct sed_key *, uint8_t *, uint8_t *, uint8_t *,
+typedef int (*set_with_buf)(struct sed_device *, const struct sed_key *, sed_uid_t, sed_uid_t, sed_uid_t,
     struct opal_req_item *, size_t);
-typedef int (*get_set_col_val)(struct sed_device *, const struct sed_key *, uint8_t *, uint8_t *, uint8_t *,
+typedef int (*get_set_col_val)(struct sed_device *, const struct sed_key *, sed_uid_t, sed_uid_t, sed_uid_t,
     uint64_t, bool, struct sed_opal_col_info *);
 typedef int (*tper_reset)(struct sed_device *);
 typedef int (*get_set_byte_table)(struct sed_device *, const struct sed_key *, const enum SED_SP_TYPE,
-    const char *, uint8_t *, uint64_t, uint64_t, uint8_t *, bool is_set);
-typedef int (*reactivate_sp)(struct sed_device *, const struct sed_key *, uint8_t *, uint8_t *, uint8_t *, char *, uint8_t,
+    const char *, sed_uid_t, uint64_t, uint64_t, uint8_t *, bool is_set);
+typedef int (*reactivate_sp)(struct sed_device *, const struct sed_key *, sed_uid_t, sed_uid_t, sed_uid_t, char *, uint8_t,
     const struct sed_key *, char *);
-typedef int (*assign)(struct sed_device *, const struct sed_key *, uint8_t *, uint8_t *, uint32_t,
+typedef int (*assign)(struct sed_device *, const struct sed_key *, sed_uid_t, sed_uid_t, uint32_t,
     uint8_t, uint8_t, struct sed_locking_object *);
-typedef int (*deassign)(struct sed_device *, const struct sed_key *, uint8_t *, uint8_t *,
-    const uint8_t *, bool);
-typedef int (*table_next)(struct sed_device *, const struct sed_key *, uint8_t *, uint8_t *, uint8_t *, uint8_t *,
+typedef int (*deassign)(struct sed_device *, const struct sed_key *, sed_uid_t, sed_uid_t,
+    sed_uid_t, bool);
+typedef int (*table_next)(struct sed_device *, const struct sed_key *, sed_uid_t, sed_uid_t, sed_uid_t, sed_uid_t,
     uint16_t, struct sed_next_uids *);
 typedef int (*authenticate)(struct sed_device *, enum SED_AUTHORITY, const struct sed_key *);
-typedef int (*get_acl)(struct sed_device *, const struct sed_key *, uint8_t *, uint8_t *, const uint8_t *,
-    const uint8_t *, struct sed_next_uids *);
+typedef int (*session_authenticate)(struct sed_device *, struct sed_session *, sed_uid_t, const struct sed_key *);
+typedef int (*get_acl)(struct sed_device *, const struct sed_key *, sed_uid_t, sed_uid_t, sed_uid_t,
+    sed_uid_t, struct sed_next_uids *);
+typedef int (*table_iter_start)(struct sed_device *, const struct sed_key *, sed_uid_t, sed_uid_t, sed_uid_t,
+    uint16_t, struct sed_table_iter *);
+typedef int (*table_iter_next)(struct sed_device *, struct sed_table_iter *);
+typedef int (*table_iter_end)(struct sed_device *, struct sed_table_iter *);
+typedef int (*get_profile)(struct sed_device *, struct sed_profile *);
+typedef int (*tune_profile)(struct sed_device *, struct sed_profile *, bool);
 typedef void (*deinit)(struct sed_device *);
 
 #define OPAL_INTERFACE(FN) FN FN ##_fn
@@ -80,6 +101,7 @@ struct opal_interface {
     OPAL_INTERFACE(init);
     OPAL_INTERFACE(host_prop);
     OPAL_INTERFACE(dev_discovery);
+    OPAL_INTERFACE(refresh_discovery);
     OPAL_INTERFACE(parse_tper_state);
     OPAL_INTERFACE(take_ownership);
     OPAL_INTERFACE(get_msid_pin);
@@ -89,6 +111,7 @@ struct opal_interface {
     OPAL_INTERFACE(setup_global_range);
     OPAL_INTERFACE(add_user_to_lr);
     OPAL_INTERFACE(enable_user);
+    OPAL_INTERFACE(enable_users);
     OPAL_INTERFACE(setup_lr);
     OPAL_INTERFACE(lock_unlock);
     OPAL_INTERFACE(set_password);
@@ -115,9 +138,15 @@ struct opal_interface {
     OPAL_INTERFACE(deassign);
     OPAL_INTERFACE(table_next);
     OPAL_INTERFACE(authenticate);
+    OPAL_INTERFACE(session_authenticate);
     OPAL_INTERFACE(get_acl);
+    OPAL_INTERFACE(table_iter_start);
+    OPAL_INTERFACE(table_iter_next);
+    OPAL_INTERFACE(table_iter_end);
     OPAL_INTERFACE(deinit);
     OPAL_INTERFACE(get_set_byte_table);
+    OPAL_INTERFACE(get_profile);
+    OPAL_INTERFACE(tune_profile);
 };
 
 #define OPAL_INTERFACE_DEF(FN) .FN ## _fn = opal_ ## FN ## _pt
@@ -126,6 +155,7 @@ static struct opal_interface nvmept_if = {
     OPAL_INTERFACE_DEF(init),
     OPAL_INTERFACE_DEF(host_prop),
     OPAL_INTERFACE_DEF(dev_discovery),
+    OPAL_INTERFACE_DEF(refresh_discovery),
     OPAL_INTERFACE_DEF(parse_tper_state),
     OPAL_INTERFACE_DEF(take_ownership),
     OPAL_INTERFACE_DEF(get_msid_pin),
@@ -135,6 +165,7 @@ static struct opal_interface nvmept_if = {
     OPAL_INTERFACE_DEF(setup_global_range),
     OPAL_INTERFACE_DEF(add_user_to_lr),
     OPAL_INTERFACE_DEF(enable_user),
+    OPAL_INTERFACE_DEF(enable_users),
     OPAL_INTERFACE_DEF(setup_lr),
     OPAL_INTERFACE_DEF(lock_unlock),
     OPAL_INTERFACE_DEF(set_password),
@@ -161,14 +192,39 @@ static struct opal_interface nvmept_if = {
     OPAL_INTERFACE_DEF(deassign),
     OPAL_INTERFACE_DEF(table_next),
     OPAL_INTERFACE_DEF(authenticate),
+    OPAL_INTERFACE_DEF(session_authenticate),
     OPAL_INTERFACE_DEF(get_acl),
+    OPAL_INTERFACE_DEF(table_iter_start),
+    OPAL_INTERFACE_DEF(table_iter_next),
+    OPAL_INTERFACE_DEF(table_iter_end),
     OPAL_INTERFACE_DEF(deinit),
     OPAL_INTERFACE_DEF(get_set_byte_table),
+    OPAL_INTERFACE_DEF(get_profile),
+    OPAL_INTERFACE_DEF(tune_profile),
 };
 
 static struct opal_interface *curr_if = &nvmept_if;
 
 uint32_t nvme_error = 0;
+
+static uint64_t now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+static void set_lr_state(struct sed_device *dev, uint8_t lr, bool read_locked, bool write_locked)
+{
+    uint16_t bit = 1 << lr;
+
+    dev->state.lr_known |= bit;
+    dev->state.lr_read_locked = read_locked ? dev->state.lr_read_locked | bit : dev->state.lr_read_locked & ~bit;
+    dev->state.lr_write_locked = write_locked ? dev->state.lr_write_locked | bit : dev->state.lr_write_locked & ~bit;
+}
+
 int sed_init(struct sed_device **dev, const char *dev_path, bool try)
 {
     struct sed_device *ret = malloc(sizeof(*ret));
@@ -184,6 +240,7 @@ int sed_init(struct sed_device **dev, const char *dev_path, bool try)
         return -EINVAL;
     }
 
+    uint64_t start = now_us();
     int status = curr_if->init_fn(ret, dev_path, try);
     if (status != 0) {
         sed_deinit(ret);
@@ -192,6 +249,9 @@ int sed_init(struct sed_device **dev, const char *dev_path, bool try)
         return status;
     }
 
+    strncpy(ret->state.dev_name, base, sizeof(ret->state.dev_name) - 1);
+    ret->state.last_op_latency = now_us() - start;
+
     *dev = ret;
 
     return status;
@@ -202,7 +262,7 @@ int sed_host_prop(struct sed_device *dev, const char *props, uint32_t *vals)
     if (curr_if->host_prop_fn == NULL)
         return -EOPNOTSUPP;
 
-    return curr_if->host_prop_fn(dev, props, vals);
+    return SED_OP(dev, curr_if->host_prop_fn(dev, props, vals));
 }
 
 int sed_dev_discovery(struct sed_device *dev, struct sed_opal_device_discovery *discovery)
@@ -210,7 +270,7 @@ int sed_dev_discovery(struct sed_device *dev, struct sed_opal_device_discovery *
     if (curr_if->dev_discovery_fn == NULL)
         return -EOPNOTSUPP;
 
-    return curr_if->dev_discovery_fn(dev, discovery);
+    return SED_OP(dev, curr_if->dev_discovery_fn(dev, discovery));
 }
 
 int sed_parse_tper_state(struct sed_device *dev, struct sed_tper_state *tper_state)
@@ -218,12 +278,25 @@ int sed_parse_tper_state(struct sed_device *dev, struct sed_tper_state *tper_sta
     if (curr_if->parse_tper_state_fn == NULL)
         return -EOPNOTSUPP;
 
-    return curr_if->parse_tper_state_fn(dev, tper_state);
+    return SED_OP(dev, curr_if->parse_tper_state_fn(dev, tper_state));
 }
 
 void sed_deinit(struct sed_device *dev)
 {
     if (dev != NULL) {
+        /*
+         * Locked and MBRDone may have changed since sed_init(), so the
+         * locking feature is read again. Without a fresh copy the previously
+         * published state is left in place rather than overwritten with
+         * stale bits.
+         */
+        if (dev->state.dev_name[0] != '\0' && curr_if->refresh_discovery_fn != NULL &&
+            curr_if->refresh_discovery_fn(dev) == 0) {
+            dev->state.locking = dev->discovery.sed_lvl0_discovery.sed_locking;
+            dev->state.updated = time(NULL);
+            sed_state_publish(&dev->state);
+        }
+
         curr_if->deinit_fn(dev);
         memset(dev, 0, sizeof(*dev));
         free(dev);
@@ -246,7 +319,7 @@ int sed_take_ownership(struct sed_device *dev, const struct sed_key *key)
     if (curr_if->take_ownership_fn == NULL)
         return -EOPNOTSUPP;
 
-    return curr_if->take_ownership_fn(dev, key);
+    return SED_OP(dev, curr_if->take_ownership_fn(dev, key));
 }
 
 int sed_get_msid_pin(struct sed_device *dev, struct sed_key *msid_pin)
@@ -254,7 +327,7 @@ int sed_get_msid_pin(struct sed_device *dev, struct sed_key *msid_pin)
     if (curr_if->get_msid_pin_fn == NULL)
         return -EOPNOTSUPP;
 
-    return curr_if->get_msid_pin_fn(dev, msid_pin);
+    return SED_OP(dev, curr_if->get_msid_pin_fn(dev, msid_pin));
 }
 
 int sed_setup_global_range(struct sed_device *dev, const struct sed_key *key, enum SED_FLAG_TYPE rle,
@@ -263,41 +336,46 @@ int sed_setup_global_range(struct sed_device *dev, const struct sed_key *key, en
     if (curr_if->setup_global_range_fn == NULL)
         return -EOPNOTSUPP;
 
-    return curr_if->setup_global_range_fn(dev, key, rle, wle);
+    return SED_OP(dev, curr_if->setup_global_range_fn(dev, key, rle, wle));
 }
 
-int sed_revert(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid, uint8_t *target_sp_uid)
+int sed_revert(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid, sed_uid_t target_sp_uid)
 {
     if (curr_if->revert_fn == NULL)
         return -EOPNOTSUPP;
 
-    return curr_if->revert_fn(dev, key, sp_uid, auth_uid, target_sp_uid);
+    return SED_OP(dev, curr_if->revert_fn(dev, key, sp_uid, auth_uid, target_sp_uid));
 }
 
- int sed_revert_lsp(struct sed_device *dev, const struct sed_key *key, uint8_t *auth_uid, bool keep_global_range_key)
+ int sed_revert_lsp(struct sed_device *dev, const struct sed_key *key, sed_uid_t auth_uid, bool keep_global_range_key)
 {
     if (curr_if->revert_lsp_fn == NULL)
         return -EOPNOTSUPP;
 
-    return curr_if->revert_lsp_fn(dev, key, auth_uid, keep_global_range_key);
+    return SED_OP(dev, curr_if->revert_lsp_fn(dev, key, auth_uid, keep_global_range_key));
 }
 
-int sed_activate_sp(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid,
-    uint8_t *target_sp_uid, char *lr_str, uint8_t range_start_length_policy, char *dsts_str)
+int sed_activate_sp(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    sed_uid_t target_sp_uid, char *lr_str, uint8_t range_start_length_policy, char *dsts_str)
 {
     if (curr_if->activate_sp_fn == NULL)
         return -EOPNOTSUPP;
 
-    return curr_if->activate_sp_fn(dev, key, sp_uid, auth_uid, target_sp_uid, lr_str, range_start_length_policy, dsts_str);
+    return SED_OP(dev, curr_if->activate_sp_fn(dev, key, sp_uid, auth_uid, target_sp_uid, lr_str, range_start_length_policy, dsts_str));
 }
 
-int sed_lock_unlock(struct sed_device *dev, const struct sed_key *key, uint8_t *auth_uid, uint8_t lr, bool sum,
+int sed_lock_unlock(struct sed_device *dev, const struct sed_key *key, sed_uid_t auth_uid, uint8_t lr, bool sum,
     enum SED_ACCESS_TYPE access_type)
 {
     if (curr_if->lock_unlock_fn == NULL)
         return -EOPNOTSUPP;
 
-    return curr_if->lock_unlock_fn(dev, key, auth_uid, lr, sum, access_type);
+    int ret = SED_OP(dev, curr_if->lock_unlock_fn(dev, key, auth_uid, lr, sum, access_type));
+    if (ret == 0 && lr < SED_OPAL_MAX_LRS)
+        set_lr_state(dev, lr, access_type & (SED_ACCESS_WO | SED_ACCESS_LK),
+            access_type & (SED_ACCESS_RO | SED_ACCESS_LK));
+
+    return ret;
 }
 
 int sed_add_user_to_lr(struct sed_device *dev, const struct sed_key *key, const char *user,
@@ -306,33 +384,42 @@ int sed_add_user_to_lr(struct sed_device *dev, const struct sed_key *key, const
     if (curr_if->add_user_to_lr_fn == NULL)
         return -EOPNOTSUPP;
 
-    return curr_if->add_user_to_lr_fn(dev, key, user, access_type, lr);
+    return SED_OP(dev, curr_if->add_user_to_lr_fn(dev, key, user, access_type, lr));
 }
 
-int sed_enable_user(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid,
-    uint8_t *user_uid)
+int sed_enable_user(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    sed_uid_t user_uid)
 {
     if (curr_if->enable_user_fn == NULL)
         return -EOPNOTSUPP;
 
-    return curr_if->enable_user_fn(dev, key, sp_uid, auth_uid, user_uid);
+    return SED_OP(dev, curr_if->enable_user_fn(dev, key, sp_uid, auth_uid, user_uid));
 }
 
-int sed_setup_lr(struct sed_device *dev, const struct sed_key *key,  uint8_t *sp_uid, uint8_t *auth_uid,
-    uint8_t *lr_uid, uint64_t range_start, uint64_t range_length, enum SED_FLAG_TYPE rle, enum SED_FLAG_TYPE wle)
+int sed_enable_users(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    const sed_uid_t *user_uids, const struct sed_key *user_keys, uint8_t count)
 {
-    return curr_if->setup_lr_fn(dev, key, sp_uid, auth_uid, lr_uid, range_start, range_length, rle, wle);
+    if (curr_if->enable_users_fn == NULL)
+        return -EOPNOTSUPP;
+
+    return SED_OP(dev, curr_if->enable_users_fn(dev, key, sp_uid, auth_uid, user_uids, user_keys, count));
+}
+
+int sed_setup_lr(struct sed_device *dev, const struct sed_key *key,  sed_uid_t sp_uid, sed_uid_t auth_uid,
+    sed_uid_t lr_uid, uint64_t range_start, uint64_t range_length, enum SED_FLAG_TYPE rle, enum SED_FLAG_TYPE wle)
+{
+    return SED_OP(dev, curr_if->setup_lr_fn(dev, key, sp_uid, auth_uid, lr_uid, range_start, range_length, rle, wle));
 }
 
-int sed_set_password(struct sed_device *dev, uint8_t *sp_uid, uint8_t *auth_uid, const struct sed_key *auth_key,
-    uint8_t *user_uid, const struct sed_key *new_user_key)
+int sed_set_password(struct sed_device *dev, sed_uid_t sp_uid, sed_uid_t auth_uid, const struct sed_key *auth_key,
+    sed_uid_t user_uid, const struct sed_key *new_user_key)
 {
-    return curr_if->set_password_fn(dev, sp_uid, auth_uid, auth_key, user_uid, new_user_key);
+    return SED_OP(dev, curr_if->set_password_fn(dev, sp_uid, auth_uid, auth_key, user_uid, new_user_key));
 }
 
 int sed_shadow_mbr(struct sed_device *dev, const struct sed_key *key, bool mbr)
 {
-    return curr_if->shadow_mbr_fn(dev, key, mbr);
+    return SED_OP(dev, curr_if->shadow_mbr_fn(dev, key, mbr));
 }
 
 int sed_read_shadow_mbr(struct sed_device *dev, enum SED_AUTHORITY auth, const struct sed_key *key,uint8_t *to,
@@ -341,7 +428,7 @@ int sed_read_shadow_mbr(struct sed_device *dev, enum SED_AUTHORITY auth, const s
     if (curr_if->read_shadow_mbr_fn == NULL)
         return -EOPNOTSUPP;
 
-    return curr_if->read_shadow_mbr_fn(dev, auth, key, to, size, offset);
+    return SED_OP(dev, curr_if->read_shadow_mbr_fn(dev, auth, key, to, size, offset));
 }
 
 int sed_write_shadow_mbr(struct sed_device *dev, const struct sed_key *key, const uint8_t *from, uint32_t size,
@@ -350,7 +437,7 @@ int sed_write_shadow_mbr(struct sed_device *dev, const struct sed_key *key, cons
     if (curr_if->write_shadow_mbr_fn == NULL)
         return -EOPNOTSUPP;
 
-    return curr_if->write_shadow_mbr_fn(dev, key, from, size, offset);
+    return SED_OP(dev, curr_if->write_shadow_mbr_fn(dev, key, from, size, offset));
 }
 
 int sed_mbr_done(struct sed_device *dev, const struct sed_key *key, bool mbr)
@@ -358,25 +445,25 @@ int sed_mbr_done(struct sed_device *dev, const struct sed_key *key, bool mbr)
     if (curr_if->mbr_done_fn == NULL)
         return -EOPNOTSUPP;
 
-    return curr_if->mbr_done_fn(dev, key, mbr);
+    return SED_OP(dev, curr_if->mbr_done_fn(dev, key, mbr));
 }
 
-int sed_erase(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid,
-    uint8_t *uid)
+int sed_erase(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    sed_uid_t uid)
 {
     if (curr_if->erase_fn == NULL)
         return -EOPNOTSUPP;
 
-    return curr_if->erase_fn(dev, key, sp_uid, auth_uid, uid);
+    return SED_OP(dev, curr_if->erase_fn(dev, key, sp_uid, auth_uid, uid));
 }
 
-int sed_genkey(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid,
-    uint8_t *uid, uint32_t public_exponent, uint32_t pin_length)
+int sed_genkey(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    sed_uid_t uid, uint32_t public_exponent, uint32_t pin_length)
 {
     if (curr_if->genkey_fn == NULL)
         return -EOPNOTSUPP;
 
-    return curr_if->genkey_fn(dev, key, sp_uid, auth_uid, uid, public_exponent, pin_length);
+    return SED_OP(dev, curr_if->genkey_fn(dev, key, sp_uid, auth_uid, uid, public_exponent, pin_length));
 }
 
 int sed_ds_read(struct sed_device *dev, enum SED_AUTHORITY auth, const struct sed_key *key, uint8_t *to, uint32_t size,
@@ -390,7 +477,7 @@ int sed_ds_read(struct sed_device *dev, enum SED_AUTHORITY auth, const struct se
         return -EINVAL;
     }
 
-    return curr_if->ds_read_fn(dev, auth, key, to, size, offset);
+    return SED_OP(dev, curr_if->ds_read_fn(dev, auth, key, to, size, offset));
 }
 
 int sed_ds_write(struct sed_device *dev, enum SED_AUTHORITY auth, const struct sed_key *key, const void *from,
@@ -404,7 +491,7 @@ int sed_ds_write(struct sed_device *dev, enum SED_AUTHORITY auth, const struct s
         return -EINVAL;
     }
 
-    return curr_if->ds_write_fn(dev, auth, key, from, size, offset);
+    return SED_OP(dev, curr_if->ds_write_fn(dev, auth, key, from, size, offset));
 }
 
 int sed_ds_add_anybody_get(struct sed_device *dev, const struct sed_key *key)
@@ -412,7 +499,7 @@ int sed_ds_add_anybody_get(struct sed_device *dev, const struct sed_key *key)
     if (curr_if->ds_add_anybody_get_fn == NULL)
         return -EOPNOTSUPP;
 
-    return curr_if->ds_add_anybody_get_fn(dev, key);
+    return SED_OP(dev, curr_if->ds_add_anybody_get_fn(dev, key));
 }
 
 int sed_list_lr(struct sed_device *dev, const struct sed_key *key, struct sed_opal_locking_ranges *lrs)
@@ -420,7 +507,13 @@ int sed_list_lr(struct sed_device *dev, const struct sed_key *key, struct sed_op
     if (curr_if->list_lr_fn == NULL)
         return -EOPNOTSUPP;
 
-    return curr_if->list_lr_fn(dev, key, lrs);
+    int ret = SED_OP(dev, curr_if->list_lr_fn(dev, key, lrs));
+    if (ret == 0) {
+        for (uint8_t i = 0; i < lrs->lr_num && i < SED_OPAL_MAX_LRS; i++)
+            set_lr_state(dev, lrs->lrs[i].lr_id, lrs->lrs[i].read_locked, lrs->lrs[i].write_locked);
+    }
+
+    return ret;
 }
 
 int sed_issue_block_sid_cmd(struct sed_device *dev, bool hw_reset)
@@ -428,7 +521,7 @@ int sed_issue_block_sid_cmd(struct sed_device *dev, bool hw_reset)
     if (curr_if->block_sid_fn == NULL)
         return -EOPNOTSUPP;
 
-    return curr_if->block_sid_fn(dev, hw_reset);
+    return SED_OP(dev, curr_if->block_sid_fn(dev, hw_reset));
 }
 
 int sed_stack_reset(struct sed_device *dev, int32_t com_id, uint64_t extended_com_id, uint8_t *response)
@@ -436,16 +529,16 @@ int sed_stack_reset(struct sed_device *dev, int32_t com_id, uint64_t extended_co
     if (curr_if->stack_reset_fn == NULL)
         return -EOPNOTSUPP;
 
-    return curr_if->stack_reset_fn(dev, com_id, extended_com_id, response);
+    return SED_OP(dev, curr_if->stack_reset_fn(dev, com_id, extended_com_id, response));
 }
 
-int sed_start_session(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid,
+int sed_start_session(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
     struct sed_session *session)
 {
     if (curr_if->start_session_fn == NULL)
         return -EOPNOTSUPP;
 
-    return curr_if->start_session_fn(dev, key, sp_uid, auth_uid, session);
+    return SED_OP(dev, curr_if->start_session_fn(dev, key, sp_uid, auth_uid, session));
 }
 
 int sed_end_session(struct sed_device *dev, struct sed_session *session)
@@ -453,7 +546,7 @@ int sed_end_session(struct sed_device *dev, struct sed_session *session)
     if (curr_if->end_session_fn == NULL)
         return -EOPNOTSUPP;
 
-    return curr_if->end_session_fn(dev, session);
+    return SED_OP(dev, curr_if->end_session_fn(dev, session));
 }
 
 int sed_start_end_transactions(struct sed_device *dev, bool start, uint8_t status)
@@ -461,34 +554,34 @@ int sed_start_end_transactions(struct sed_device *dev, bool start, uint8_t statu
     if (curr_if->start_end_transactions_fn == NULL)
         return -EOPNOTSUPP;
 
-    return curr_if->start_end_transactions_fn(dev, start, status);
+    return SED_OP(dev, curr_if->start_end_transactions_fn(dev, start, status));
 }
 
-int sed_set_with_buf(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid,
-    uint8_t *uid, struct opal_req_item *cmd, size_t cmd_len)
+int sed_set_with_buf(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    sed_uid_t uid, struct opal_req_item *cmd, size_t cmd_len)
 {
     if (curr_if->set_with_buf_fn == NULL)
         return -EOPNOTSUPP;
 
-    return curr_if->set_with_buf_fn(dev, key, sp_uid, auth_uid, uid, cmd, cmd_len);
+    return SED_OP(dev, curr_if->set_with_buf_fn(dev, key, sp_uid, auth_uid, uid, cmd, cmd_len));
 }
 
-int sed_get_set_col_val(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid,
-    uint8_t *uid, uint64_t col, bool get, struct sed_opal_col_info *col_info)
+int sed_get_set_col_val(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    sed_uid_t uid, uint64_t col, bool get, struct sed_opal_col_info *col_info)
 {
     if (curr_if->get_set_col_val_fn == NULL)
         return -EOPNOTSUPP;
 
-    return curr_if->get_set_col_val_fn(dev, key, sp_uid, auth_uid, uid, col, get, col_info);
+    return SED_OP(dev, curr_if->get_set_col_val_fn(dev, key, sp_uid, auth_uid, uid, col, get, col_info));
 }
 
 int sed_get_set_byte_table(struct sed_device *dev, const struct sed_key *key, const enum SED_SP_TYPE sp,
-    const char *user, uint8_t *uid, uint64_t start, uint64_t end, uint8_t *buffer, bool is_set)
+    const char *user, sed_uid_t uid, uint64_t start, uint64_t end, uint8_t *buffer, bool is_set)
 {
     if (curr_if->get_set_byte_table_fn == NULL)
         return -EOPNOTSUPP;
 
-    return curr_if->get_set_byte_table_fn(dev, key, sp, user, uid, start, end, buffer, is_set);
+    return SED_OP(dev, curr_if->get_set_byte_table_fn(dev, key, sp, user, uid, start, end, buffer, is_set));
 }
 
 int sed_tper_reset(struct sed_device *dev)
@@ -496,43 +589,43 @@ int sed_tper_reset(struct sed_device *dev)
     if (curr_if->tper_reset_fn == NULL)
         return -EOPNOTSUPP;
 
-    return curr_if->tper_reset_fn(dev);
+    return SED_OP(dev, curr_if->tper_reset_fn(dev));
 }
 
-int sed_reactivate_sp(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid,
-    uint8_t *target_sp_uid, char *lr_str, uint8_t range_start_length_policy, const struct sed_key *admin1_pwd, char *dsts_str)
+int sed_reactivate_sp(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    sed_uid_t target_sp_uid, char *lr_str, uint8_t range_start_length_policy, const struct sed_key *admin1_pwd, char *dsts_str)
 {
     if (curr_if->reactivate_sp_fn == NULL)
         return -EOPNOTSUPP;
 
-    return curr_if->reactivate_sp_fn(dev, key, sp_uid, auth_uid, target_sp_uid, lr_str, range_start_length_policy, admin1_pwd, dsts_str);
+    return SED_OP(dev, curr_if->reactivate_sp_fn(dev, key, sp_uid, auth_uid, target_sp_uid, lr_str, range_start_length_policy, admin1_pwd, dsts_str));
 }
 
-int sed_assign(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid,
+int sed_assign(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
     uint32_t nsid, uint8_t range_start, uint8_t range_len, struct sed_locking_object *info)
 {
     if (curr_if->assign_fn == NULL)
         return -EOPNOTSUPP;
 
-    return curr_if->assign_fn(dev, key, sp_uid, auth_uid, nsid, range_start, range_len, info);
+    return SED_OP(dev, curr_if->assign_fn(dev, key, sp_uid, auth_uid, nsid, range_start, range_len, info));
 }
 
-int sed_deassign(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid,
-    const uint8_t *uid, bool keep_ns_global_range_key)
+int sed_deassign(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    sed_uid_t uid, bool keep_ns_global_range_key)
 {
     if (curr_if->deassign_fn == NULL)
         return -EOPNOTSUPP;
 
-    return curr_if->deassign_fn(dev, key, sp_uid, auth_uid, uid, keep_ns_global_range_key);
+    return SED_OP(dev, curr_if->deassign_fn(dev, key, sp_uid, auth_uid, uid, keep_ns_global_range_key));
 }
 
-int sed_table_next(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid,
-    uint8_t *uid, uint8_t *where, uint16_t count, struct sed_next_uids *next_uids)
+int sed_table_next(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    sed_uid_t uid, sed_uid_t where, uint16_t count, struct sed_next_uids *next_uids)
 {
     if (curr_if->table_next_fn == NULL)
         return -EOPNOTSUPP;
 
-    return curr_if->table_next_fn(dev, key, sp_uid, auth_uid, uid, where, count, next_uids);
+    return SED_OP(dev, curr_if->table_next_fn(dev, key, sp_uid, auth_uid, uid, where, count, next_uids));
 }
 
 int sed_authenticate(struct sed_device *dev, enum SED_AUTHORITY auth, const struct sed_key *key)
@@ -540,14 +633,75 @@ int sed_authenticate(struct sed_device *dev, enum SED_AUTHORITY auth, const stru
     if (curr_if->authenticate_fn == NULL)
         return -EOPNOTSUPP;
 
-    return curr_if->authenticate_fn(dev, auth, key);
+    return SED_OP(dev, curr_if->authenticate_fn(dev, auth, key));
+}
+
+int sed_session_authenticate(struct sed_device *dev, struct sed_session *session, sed_uid_t auth_uid,
+    const struct sed_key *key)
+{
+    if (curr_if->session_authenticate_fn == NULL)
+        return -EOPNOTSUPP;
+
+    return SED_OP(dev, curr_if->session_authenticate_fn(dev, session, auth_uid, key));
 }
 
-int sed_get_acl(struct sed_device *dev, const struct sed_key *key, uint8_t *sp_uid, uint8_t *auth_uid,
-    const uint8_t *invoking_uid, const uint8_t *method_uid, struct sed_next_uids *next_uids)
+int sed_get_acl(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    sed_uid_t invoking_uid, sed_uid_t method_uid, struct sed_next_uids *next_uids)
 {
     if (curr_if->get_acl_fn == NULL)
         return -EOPNOTSUPP;
 
-    return curr_if->get_acl_fn(dev, key, sp_uid, auth_uid, invoking_uid, method_uid, next_uids);
+    return SED_OP(dev, curr_if->get_acl_fn(dev, key, sp_uid, auth_uid, invoking_uid, method_uid, next_uids));
+}
+
+void sed_next_uids_free(struct sed_next_uids *next_uids)
+{
+    free(next_uids->uids);
+    memset(next_uids, 0, sizeof(*next_uids));
+}
+
+int sed_table_iter_start(struct sed_device *dev, const struct sed_key *key, sed_uid_t sp_uid, sed_uid_t auth_uid,
+    sed_uid_t uid, uint16_t count, struct sed_table_iter *iter)
+{
+    if (curr_if->table_iter_start_fn == NULL)
+        return -EOPNOTSUPP;
+
+    return SED_OP(dev, curr_if->table_iter_start_fn(dev, key, sp_uid, auth_uid, uid, count, iter));
+}
+
+int sed_table_iter_next(struct sed_device *dev, struct sed_table_iter *iter)
+{
+    if (curr_if->table_iter_next_fn == NULL)
+        return -EOPNOTSUPP;
+
+    return SED_OP(dev, curr_if->table_iter_next_fn(dev, iter));
+}
+
+int sed_table_iter_end(struct sed_device *dev, struct sed_table_iter *iter)
+{
+    if (curr_if->table_iter_end_fn == NULL)
+        return -EOPNOTSUPP;
+
+    return SED_OP(dev, curr_if->table_iter_end_fn(dev, iter));
+}
+
+int sed_get_profile(struct sed_device *dev, struct sed_profile *profile)
+{
+    if (curr_if->get_profile_fn == NULL)
+        return -EOPNOTSUPP;
+
+    return SED_OP(dev, curr_if->get_profile_fn(dev, profile));
+}
+
+int sed_tune_profile(struct sed_device *dev, struct sed_profile *profile, bool store)
+{
+    if (curr_if->tune_profile_fn == NULL)
+        return -EOPNOTSUPP;
+
+    return SED_OP(dev, curr_if->tune_profile_fn(dev, profile, store));
+}
+
+int sed_get_state(const char *dev_path, struct sed_state *state)
+{
+    return sed_state_read(basename(dev_path), state);
 }
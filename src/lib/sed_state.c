@@ -0,0 +1,228 @@
+/*
+ * Copyright (C) 2018-2019, 2022-2023 Solidigm. All Rights Reserved.
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "sed_state.h"
+#include "sedcli_log.h"
+
+#define SED_STATE_MAGIC      0x53454453 /* "SEDS" */
+#define SED_STATE_VERSION    1
+#define SED_STATE_READ_TRIES 1000
+
+/*
+ * Each entry is guarded by a sequence lock: the writer makes the sequence odd
+ * while it updates the entry and even again when done. Readers copy the entry
+ * and retry if the sequence was odd or changed meanwhile, so they never block
+ * the writers nor enter the kernel. Writers serialize on flock() of the table.
+ */
+struct sed_state_entry {
+    atomic_uint seq;
+    uint32_t reserved;
+    struct sed_state state;
+};
+
+struct sed_state_table {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t max_devices;
+    uint32_t reserved;
+    struct sed_state_entry entries[SED_STATE_MAX_DEVICES];
+};
+
+static const struct sed_state_table *read_table;
+
+/*
+ * The table lives in world-writable /dev/shm, so anybody could have created
+ * it first. Only trust a table owned by one of the given users that nobody
+ * else can write to.
+ */
+static bool table_is_trusted(const struct stat *st, uid_t owner, uid_t alt_owner)
+{
+    if (st->st_uid != owner && st->st_uid != alt_owner) {
+        SEDCLI_DEBUG_PARAM("State table is owned by unexpected user %u\n", st->st_uid);
+        return false;
+    }
+
+    if (st->st_mode & (S_IWGRP | S_IWOTH)) {
+        SEDCLI_DEBUG_MSG("State table is writable by group or others\n");
+        return false;
+    }
+
+    return true;
+}
+
+static struct sed_state_entry *find_entry(struct sed_state_table *table, const char *dev_name, bool alloc)
+{
+    struct sed_state_entry *free_entry = NULL;
+
+    for (uint32_t i = 0; i < SED_STATE_MAX_DEVICES; i++) {
+        struct sed_state_entry *entry = &table->entries[i];
+
+        if (entry->state.dev_name[0] == '\0') {
+            if (free_entry == NULL)
+                free_entry = entry;
+            continue;
+        }
+
+        if (!strncmp(entry->state.dev_name, dev_name, SED_STATE_NAME_LEN))
+            return entry;
+    }
+
+    return alloc ? free_entry : NULL;
+}
+
+static void write_entry(struct sed_state_entry *entry, const struct sed_state *state)
+{
+    struct sed_state merged = *state;
+    uint16_t keep = entry->state.lr_known & ~state->lr_known;
+
+    merged.lr_known |= entry->state.lr_known;
+    merged.lr_read_locked |= entry->state.lr_read_locked & keep;
+    merged.lr_write_locked |= entry->state.lr_write_locked & keep;
+
+    /* A writer that died midway leaves the sequence odd */
+    unsigned int seq = atomic_load_explicit(&entry->seq, memory_order_relaxed) | 1;
+
+    atomic_store_explicit(&entry->seq, seq, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    entry->state = merged;
+
+    atomic_store_explicit(&entry->seq, seq + 1, memory_order_release);
+}
+
+int sed_state_publish(const struct sed_state *state)
+{
+    struct sed_state_table *table;
+    int ret = 0;
+
+    int fd = shm_open(SED_STATE_SHM_NAME, O_RDWR | O_CREAT, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    if (fd < 0) {
+        SEDCLI_DEBUG_PARAM("Unable to open the state table: %d\n", errno);
+        return -errno;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st)) {
+        ret = -errno;
+        goto close_fd;
+    }
+
+    /* Checked before locking, a forged table could be held locked forever */
+    if (!table_is_trusted(&st, geteuid(), geteuid())) {
+        ret = -EPERM;
+        goto close_fd;
+    }
+
+    if (flock(fd, LOCK_EX)) {
+        ret = -errno;
+        goto close_fd;
+    }
+
+    /* Another writer may have sized the table while we waited for the lock */
+    if (fstat(fd, &st)) {
+        ret = -errno;
+        goto close_fd;
+    }
+
+    if (st.st_size < (off_t)sizeof(*table) && ftruncate(fd, sizeof(*table))) {
+        ret = -errno;
+        goto close_fd;
+    }
+
+    table = mmap(NULL, sizeof(*table), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (table == MAP_FAILED) {
+        ret = -errno;
+        goto close_fd;
+    }
+
+    if (table->magic != SED_STATE_MAGIC) {
+        table->version = SED_STATE_VERSION;
+        table->max_devices = SED_STATE_MAX_DEVICES;
+        table->magic = SED_STATE_MAGIC;
+    }
+
+    struct sed_state_entry *entry = find_entry(table, state->dev_name, true);
+    if (entry == NULL) {
+        SEDCLI_DEBUG_PARAM("No room for %s in the state table\n", state->dev_name);
+        ret = -ENOSPC;
+    } else {
+        write_entry(entry, state);
+    }
+
+    munmap(table, sizeof(*table));
+
+close_fd:
+    /* Closing the descriptor drops the lock */
+    close(fd);
+
+    return ret;
+}
+
+static const struct sed_state_table *map_read_table(void)
+{
+    const struct sed_state_table *table = read_table;
+    if (table != NULL)
+        return table;
+
+    int fd = shm_open(SED_STATE_SHM_NAME, O_RDONLY, 0);
+    if (fd < 0)
+        return NULL;
+
+    /* The table is normally published by root, readers need not be */
+    struct stat st;
+    if (fstat(fd, &st) || !table_is_trusted(&st, 0, geteuid()) || st.st_size < (off_t)sizeof(*table)) {
+        close(fd);
+        return NULL;
+    }
+
+    table = mmap(NULL, sizeof(*table), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (table == MAP_FAILED)
+        return NULL;
+
+    if (table->magic != SED_STATE_MAGIC || table->version != SED_STATE_VERSION) {
+        munmap((void *)table, sizeof(*table));
+        return NULL;
+    }
+
+    read_table = table;
+
+    return table;
+}
+
+int sed_state_read(const char *dev_name, struct sed_state *state)
+{
+    const struct sed_state_table *table = map_read_table();
+    if (table == NULL)
+        return -ENOENT;
+
+    const struct sed_state_entry *entry = find_entry((struct sed_state_table *)table, dev_name, false);
+    if (entry == NULL)
+        return -ENOENT;
+
+    for (int i = 0; i < SED_STATE_READ_TRIES; i++) {
+        unsigned int seq = atomic_load_explicit(&entry->seq, memory_order_acquire);
+        if (seq & 1)
+            continue;
+
+        *state = entry->state;
+
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&entry->seq, memory_order_relaxed) == seq)
+            return 0;
+    }
+
+    return -EAGAIN;
+}
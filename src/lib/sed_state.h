@@ -0,0 +1,26 @@
+/*
+ * Copyright (C) 2018-2019, 2022-2023 Solidigm. All Rights Reserved.
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef _SED_STATE_H_
+#define _SED_STATE_H_
+
+#include "libsed.h"
+
+#define SED_STATE_SHM_NAME    "/sedcli_state"
+#define SED_STATE_MAX_DEVICES 64
+
+/*
+ * Publish the state of a drive in the shared state table. Locking range bits
+ * not set in lr_known are kept from the previously published state.
+ */
+int sed_state_publish(const struct sed_state *state);
+
+/*
+ * Read a consistent snapshot of the state published for dev_name.
+ */
+int sed_state_read(const char *dev_name, struct sed_state *state);
+
+#endif /* _SED_STATE_H_ */
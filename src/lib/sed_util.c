@@ -15,6 +15,7 @@
 #include <errno.h>
 #include <unistd.h>
 #include <ctype.h>
+#include <endian.h>
 #include <syslog.h>
 
 #include "../argp.h"
@@ -25,7 +26,7 @@
 
 #define ARRAY_SIZE(x) (sizeof(x) / sizeof(x[0]))
 
-extern uint8_t opal_uid[][OPAL_UID_LENGTH];
+extern const sed_uid_t opal_uid[];
 
 extern sedcli_printf_t sedcli_printf;
 
@@ -98,39 +99,52 @@ int sed2opal_map[] = {
     [SED_ERASE_MASTER] = OPAL_ENTERPRISE_ERASEMASTER_UID
 };
 
-bool parse_uid(char **arg, uint8_t *uid)
+bool parse_uid(char **arg, sed_uid_t *uid)
 {
     // uid in hex as 8 bytes table format 00-01-02-03-04-05-06-07
-    uint8_t id = 0;
+    sed_uid_t val = 0;
     char *p = arg[0];
 
-    // parse all nums from table
-    char *str;
-    while (id < 8) {
-        if (isxdigit(p[0]) == false || isxdigit(p[1]) == false)
-            return false;
-
-        // parse two-chars num as hex
-        char byte[3];
-        memcpy(byte, p, sizeof(char) * 2);
-        byte[2] = 0;
-        uid[id++] = (int)strtoul(byte, &str, 16);
-        if (str == byte)
-            return false;
+    for (uint8_t id = 0; id < OPAL_UID_LENGTH; id++) {
+        for (uint8_t i = 0; i < 2; i++, p++) {
+            if (isxdigit(*p) == false)
+                return false;
 
-        // skip 2 bytes for already parsed num
-        p += 2;
+            val = (val << 4) | (isdigit(*p) ? *p - '0' : tolower(*p) - 'a' + 10);
+        }
 
-        // skip 1 byte for dash
-        if (id < 7 && *p != '-')
+        // skip the dash between bytes
+        if (id < OPAL_UID_LENGTH - 1 && *p++ != '-')
             return false;
-        p += 1;
     }
 
+    *uid = val;
+
     return true;
 }
 
-int get_opal_user_auth_uid(char *user_auth, bool user_auth_is_uid, uint8_t *user_auth_uid)
+sed_uid_t uid_from_bytes(const uint8_t *bytes)
+{
+    uint64_t val;
+
+    memcpy(&val, bytes, sizeof(val));
+
+    return be64toh(val);
+}
+
+sed_uid_t uid_set_byte(sed_uid_t uid, uint8_t idx, uint8_t val)
+{
+    uint8_t shift = 8 * (OPAL_UID_LENGTH - 1 - idx);
+
+    return (uid & ~(0xffULL << shift)) | ((sed_uid_t)val << shift);
+}
+
+uint8_t uid_get_byte(sed_uid_t uid, uint8_t idx)
+{
+    return uid >> (8 * (OPAL_UID_LENGTH - 1 - idx));
+}
+
+int get_opal_user_auth_uid(char *user_auth, bool user_auth_is_uid, sed_uid_t *user_auth_uid)
 {
     if (user_auth_is_uid == false) {
         uint8_t user_auth_id;
@@ -152,7 +166,7 @@ int get_opal_user_auth_uid(char *user_auth, bool user_auth_is_uid, uint8_t *user
                             if (sed_cli == SED_CLI_STANDARD) {
                                 sedcli_printf(LOG_INFO, "Found alias for %s: ", user_auth);
                                 for (uint8_t i = 0; i < OPAL_UID_LENGTH; i++) {
-                                    sedcli_printf(LOG_INFO, "%02x", user_auth_uid[i]);
+                                    sedcli_printf(LOG_INFO, "%02x", uid_get_byte(*user_auth_uid, i));
                                     if (i < OPAL_UID_LENGTH - 1)
                                         sedcli_printf(LOG_INFO, "-");
                                     else
@@ -174,7 +188,7 @@ int get_opal_user_auth_uid(char *user_auth, bool user_auth_is_uid, uint8_t *user
         if (sed_get_authority_uid(user_auth, &user_auth_id) != SED_SUCCESS)
             return -EINVAL;
 
-        memcpy(user_auth_uid, opal_uid[user_auth_id], sizeof(uint8_t) * OPAL_UID_LENGTH);
+        *user_auth_uid = opal_uid[user_auth_id];
     }
 
     return SED_SUCCESS;
@@ -197,7 +211,7 @@ int sp2uid_map[] = {
     [SED_THIS_SP] = OPAL_THIS_SP_UID,
 };
 
-int get_opal_sp_uid(enum SED_SP_TYPE sp, uint8_t *sp_uid)
+int get_opal_sp_uid(enum SED_SP_TYPE sp, sed_uid_t *sp_uid)
 {
     if (sp == SED_UID_SP)
         return SED_SUCCESS;
@@ -207,7 +221,7 @@ int get_opal_sp_uid(enum SED_SP_TYPE sp, uint8_t *sp_uid)
         return -EINVAL;
     }
 
-    memcpy(sp_uid, opal_uid[sp2uid_map[sp]], sizeof(uint8_t) * OPAL_UID_LENGTH);
+    *sp_uid = opal_uid[sp2uid_map[sp]];
 
     return SED_SUCCESS;
 }
@@ -258,23 +272,13 @@ int sed_get_user_admin(const char *user, uint32_t *who, bool *admin)
     return 0;
 }
 
-bool compare_uid(uint8_t *uid1, uint8_t *uid2)
-{
-    if (memcmp(uid1, uid2, sizeof(uint8_t) * OPAL_UID_LENGTH) == 0)
-        return true;
-
-    return false;
-}
-
-bool compare_uid_range(uint8_t *uid1, uint8_t *uid2, uint8_t start, uint8_t end)
+/*
+ * Check whether uid1 with its last byte replaced by a value from [start, end)
+ * can be equal to uid2.
+ */
+bool compare_uid_range(sed_uid_t uid1, sed_uid_t uid2, uint8_t start, uint8_t end)
 {
-    uint8_t uid_temp[OPAL_UID_LENGTH];
-    memcpy(uid_temp, uid1, sizeof(uint8_t) * OPAL_UID_LENGTH);
-    for (uint8_t i = start; i < end; i++) {
-        uid_temp[OPAL_UID_LENGTH - 1] = i;
-        if (memcmp(uid_temp, uid2, sizeof(uint8_t) * OPAL_UID_LENGTH) == 0)
-            return true;
-    }
+    uint8_t last = uid2 & 0xff;
 
-    return false;
+    return (uid1 >> 8) == (uid2 >> 8) && last >= start && last < end;
 }
@@ -14,20 +14,23 @@ struct sed_device {
     int fd;
     struct sed_opal_device_discovery discovery;
     void *priv;
+    struct sed_state state;
 };
 
 int open_dev(const char *dev, bool try);
 
-bool parse_uid(char **arg, uint8_t *uid);
+bool parse_uid(char **arg, sed_uid_t *uid);
+sed_uid_t uid_from_bytes(const uint8_t *bytes);
+sed_uid_t uid_set_byte(sed_uid_t uid, uint8_t idx, uint8_t val);
+uint8_t uid_get_byte(sed_uid_t uid, uint8_t idx);
 int sed_get_user_admin(const char *user, uint32_t *who, bool *admin);
 
 int sed_get_authority_uid(const char *user, uint8_t *user_uid);
 int get_opal_auth_id(enum SED_AUTHORITY auth, uint8_t *auth_uid);
 
-int get_opal_user_auth_uid(char *user_auth, bool user_auth_is_uid, uint8_t *user_auth_uid);
-int get_opal_sp_uid(enum SED_SP_TYPE sp, uint8_t *sp_uid);
+int get_opal_user_auth_uid(char *user_auth, bool user_auth_is_uid, sed_uid_t *user_auth_uid);
+int get_opal_sp_uid(enum SED_SP_TYPE sp, sed_uid_t *sp_uid);
 
-bool compare_uid(uint8_t *uid1, uint8_t *uid2);
-bool compare_uid_range(uint8_t *uid1, uint8_t *uid2, uint8_t start, uint8_t end);
+bool compare_uid_range(sed_uid_t uid1, sed_uid_t uid2, uint8_t start, uint8_t end);
 
 #endif /* _SED_UTIL_H_ */
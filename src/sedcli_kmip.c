@@ -36,7 +36,7 @@
 
 extern sedcli_printf_t sedcli_printf;
 
-extern uint8_t opal_uid[][OPAL_UID_LENGTH];
+extern const sed_uid_t opal_uid[];
 
 static int handle_connection_test_opts(char *opt, char **arg);
 static int handle_provision_opts(char *opt, char **arg);
@@ -53,6 +53,7 @@ static int handle_get_lock_info(void);
 static int handle_revert_tper(void);
 
 static int read_key_from_datastore(struct sed_device *sed_dev, struct sed_key *dek_key);
+static void pek_cache_deinit(void);
 
 static int programmatic_reset_enable(struct sed_device *sed_dev, const struct sed_key *key);
 
@@ -72,7 +73,7 @@ static cli_option provision_opts[] = {
 };
 
 static cli_option lock_unlock_opts[] = {
-    {'d', "device", "Device node e.g. /dev/nvme0n1", 1, "DEVICE", CLI_OPTION_REQUIRED},
+    {'d', "device", "Device nodes e.g. /dev/nvme0n1 /dev/nvme1n1", MAX_SCAN_DEVS, "DEVICE", CLI_OPTION_REQUIRED},
     {'t', "access-type", "String specifying access type to the data on drive. Allowed values: RO/WO/RW/LK", 1, "FMT", CLI_OPTION_REQUIRED},
     {0}
 };
@@ -101,7 +102,8 @@ static cli_command sedcli_commands[] = {
     {
         .name = "lock-unlock",
         .desc = "Lock or unlock global locking range.",
-        .long_desc = "Lock or unlock global locking range in Locking SP using key retrieved from KMS.",
+        .long_desc = "Lock or unlock global locking range in Locking SP using key retrieved from KMS.\n"
+                     "   Drives sharing a PEK are served by a single request to the KMS.",
         .options = lock_unlock_opts,
         .options_parse = handle_lock_unlock_opts,
         .handle = handle_lock_unlock,
@@ -163,6 +165,32 @@ static cli_command sedcli_commands[] = {
 
 static char *dev_path;
 
+static char *dev_paths[MAX_SCAN_DEVS];
+static uint8_t dev_count;
+
+#define MAX_PEK_LEN 64
+
+/*
+ * PEKs retrieved from the KMS by this run, keyed by PEK ID. All of them are
+ * fetched over one KMIP connection and each distinct PEK with a single Get,
+ * before the drives are served, e.g. unlocking all drives of a platform.
+ */
+struct pek_cache_entry {
+    uint8_t pek_id[MAX_PEK_ID_LEN];
+    uint32_t pek_id_size;
+    uint8_t pek[MAX_PEK_LEN];
+    int pek_size;
+};
+
+struct pek_cache {
+    struct sed_kmip_ctx ctx;
+    bool connected;
+    uint8_t count;
+    struct pek_cache_entry entries[MAX_SCAN_DEVS];
+};
+
+static struct pek_cache *pek_cache;
+
 struct sedcli_options {
     uint8_t pwd_len;
     uint8_t repeated_pwd_len;
@@ -297,7 +325,23 @@ static int handle_provision_opts(char *opt, char **arg)
 static int handle_lock_unlock_opts(char *opt, char **arg)
 {
     if (!strncmp(opt, "device", MAX_INPUT)) {
-        dev_path = (char *) arg[0];
+        for (uint8_t i = 0; arg[i] != NULL; i++) {
+            bool dup = false;
+
+            /* The same drive listed twice is handled once */
+            for (uint8_t j = 0; j < dev_count && !dup; j++)
+                dup = !strcmp(dev_paths[j], arg[i]);
+
+            if (dup)
+                continue;
+
+            if (dev_count >= MAX_SCAN_DEVS) {
+                sedcli_printf(LOG_ERR, "Too many devices provided.\n");
+                return -EINVAL;
+            }
+
+            dev_paths[dev_count++] = (char *) arg[i];
+        }
     } else if (!strncmp(opt, "access-type", MAX_INPUT)) {
         int err = get_access_type(arg[0], &opts->access_type);
         if (err == -EINVAL) {
@@ -413,6 +457,7 @@ static int handle_revert_tper(void)
 
 deinit:
     sed_deinit(dev);
+    pek_cache_deinit();
 
     if (key)
         free_locked_buffer(key, 2 * sizeof(*key));
@@ -617,7 +662,7 @@ deinit:
     return status;
 }
 
-static int read_key_from_datastore(struct sed_device *sed_dev, struct sed_key *dek_key)
+static int pek_cache_connect(void)
 {
     int status = read_stat_config(conf_stat_file);
     if (status) {
@@ -625,34 +670,7 @@ static int read_key_from_datastore(struct sed_device *sed_dev, struct sed_key *d
         return -1;
     }
 
-    int ret = 0;
-
-    uint8_t *pek = NULL;
-    struct sedcli_metadata *meta = NULL;
-
-    struct sed_kmip_ctx *ctx = malloc(sizeof(*ctx));
-    if (!ctx) {
-        sedcli_printf(LOG_ERR, "Failed to allocate memory.\n");
-        ret = -ENOMEM;
-        goto deinit;
-    }
-    memset(ctx, 0, sizeof(struct sed_kmip_ctx));
-
-    meta = sedcli_metadata_alloc_buffer();
-    if (!meta) {
-        sedcli_printf(LOG_ERR, "Failed to allocate memory.\n");
-        ret = -ENOMEM;
-        goto deinit;
-    }
-
-    status = sed_ds_read(sed_dev, SED_ANYBODY, NULL, (uint8_t *)meta, SEDCLI_METADATA_SIZE, 0);
-    if (status) {
-        sedcli_printf(LOG_ERR, "Can't read sedcli metadata from datastore.\n");
-        ret = status;
-        goto deinit;
-    }
-
-    status = sed_kmip_init(ctx, conf_stat_file->kmip_ip,
+    status = sed_kmip_init(&pek_cache->ctx, conf_stat_file->kmip_ip,
                    conf_stat_file->kmip_port,
                    conf_stat_file->client_cert_path,
                    conf_stat_file->client_key_path,
@@ -660,27 +678,90 @@ static int read_key_from_datastore(struct sed_device *sed_dev, struct sed_key *d
 
     if (status == -1) {
         sedcli_printf(LOG_ERR, "Can't initialize KMIP connection.\n");
-        ret = KMIP_FAILURE;
-        goto deinit;
+        return KMIP_FAILURE;
     }
 
-    status = sed_kmip_connect(ctx);
+    status = sed_kmip_connect(&pek_cache->ctx);
     if (status) {
         sedcli_printf(LOG_ERR, "Can't connect to KMIP.\n");
-        ret = KMIP_FAILURE;
-        goto deinit;
+        sed_kmip_deinit(&pek_cache->ctx);
+        return KMIP_FAILURE;
+    }
+
+    pek_cache->connected = true;
+
+    return 0;
+}
+
+static void pek_cache_deinit(void)
+{
+    if (pek_cache == NULL)
+        return;
+
+    if (pek_cache->connected)
+        sed_kmip_deinit(&pek_cache->ctx);
+
+    free_locked_buffer(pek_cache, sizeof(*pek_cache));
+    pek_cache = NULL;
+}
+
+static int get_pek(uint8_t *pek_id, uint32_t pek_id_size, struct pek_cache_entry **entry)
+{
+    if (pek_id_size == 0 || pek_id_size > MAX_PEK_ID_LEN)
+        return -EINVAL;
+
+    if (pek_cache == NULL) {
+        pek_cache = alloc_locked_buffer(sizeof(*pek_cache));
+        if (pek_cache == NULL) {
+            sedcli_printf(LOG_ERR, "Failed to allocate memory.\n");
+            return -ENOMEM;
+        }
+        memset(pek_cache, 0, sizeof(*pek_cache));
     }
 
+    for (uint8_t i = 0; i < pek_cache->count; i++) {
+        *entry = &pek_cache->entries[i];
+        if ((*entry)->pek_id_size == pek_id_size && !memcmp((*entry)->pek_id, pek_id, pek_id_size))
+            return 0;
+    }
+
+    if (pek_cache->count == MAX_SCAN_DEVS)
+        return -ENOSPC;
+
+    if (!pek_cache->connected) {
+        int status = pek_cache_connect();
+        if (status)
+            return status;
+    }
+
+    uint8_t *pek = NULL;
     int pek_size = 0;
-    uint8_t *pek_id = sedcli_meta_get_pek_id_addr(meta);
-    uint32_t pek_id_size = sedcli_meta_get_pek_id_size(meta);
-    status = sed_kmip_get_platform_key(ctx, (char *)pek_id, pek_id_size, (char **)&pek, &pek_size);
+    int status = sed_kmip_get_platform_key(&pek_cache->ctx, (char *)pek_id, pek_id_size, (char **)&pek, &pek_size);
     if (status) {
         sedcli_printf(LOG_ERR, "Can't get PEK from KMIP.\n");
-        ret = KMIP_FAILURE;
-        goto deinit;
+        return KMIP_FAILURE;
+    }
+
+    if (pek_size <= 0 || pek_size > MAX_PEK_LEN) {
+        sedcli_printf(LOG_ERR, "Unexpected PEK size: %d\n", pek_size);
+        status = KMIP_FAILURE;
+    } else {
+        *entry = &pek_cache->entries[pek_cache->count++];
+        memcpy((*entry)->pek_id, pek_id, pek_id_size);
+        (*entry)->pek_id_size = pek_id_size;
+        memcpy((*entry)->pek, pek, pek_size);
+        (*entry)->pek_size = pek_size;
     }
 
+    memset(pek, 0, pek_size);
+    free(pek);
+
+    return status;
+}
+
+static int decrypt_meta_dek(struct sedcli_metadata *meta, const struct pek_cache_entry *pek,
+    struct sed_key *dek_key)
+{
     uint8_t *iv = sedcli_meta_get_iv_addr(meta);
     uint32_t iv_size = sedcli_meta_get_iv_size(meta);
     uint8_t *enc_dek = sedcli_meta_get_enc_dek_addr(meta);
@@ -688,27 +769,48 @@ static int read_key_from_datastore(struct sed_device *sed_dev, struct sed_key *d
     uint8_t *tag = sedcli_meta_get_tag_addr(meta);
     uint32_t tag_size = sedcli_meta_get_tag_size(meta);
     int auth_len = (enc_dek - (uint8_t *)meta);
-    status = decrypt_dek(enc_dek, enc_dek_size, (uint8_t *)meta, auth_len, (uint8_t *)(dek_key->key), SED_KMIP_KEY_LEN,
-        pek, pek_size, iv, iv_size, tag, tag_size);
+    int status = decrypt_dek(enc_dek, enc_dek_size, (uint8_t *)meta, auth_len, (uint8_t *)(dek_key->key),
+        SED_KMIP_KEY_LEN, (uint8_t *)pek->pek, pek->pek_size, iv, iv_size, tag, tag_size);
     if (status != SED_KMIP_KEY_LEN) {
         sedcli_printf(LOG_ERR, "Error while decrypting DEK key.\n");
-        ret = KMIP_FAILURE;
-        goto deinit;
+        return KMIP_FAILURE;
     }
 
     dek_key->len = status;
 
-deinit:
-    sed_kmip_deinit(ctx);
+    return 0;
+}
 
-    if (meta)
-        sedcli_metadata_free_buffer(meta);
+static int read_key_from_datastore(struct sed_device *sed_dev, struct sed_key *dek_key)
+{
+    int status, ret = 0;
 
-    if (pek)
-        free(pek);
+    struct sedcli_metadata *meta = sedcli_metadata_alloc_buffer();
+    if (!meta) {
+        sedcli_printf(LOG_ERR, "Failed to allocate memory.\n");
+        return -ENOMEM;
+    }
 
-    if (ctx)
-        free(ctx);
+    status = sed_ds_read(sed_dev, SED_ANYBODY, NULL, (uint8_t *)meta, SEDCLI_METADATA_SIZE, 0);
+    if (status) {
+        sedcli_printf(LOG_ERR, "Can't read sedcli metadata from datastore.\n");
+        ret = status;
+        goto deinit;
+    }
+
+    struct pek_cache_entry *pek = NULL;
+    uint8_t *pek_id = sedcli_meta_get_pek_id_addr(meta);
+    uint32_t pek_id_size = sedcli_meta_get_pek_id_size(meta);
+    status = get_pek(pek_id, pek_id_size, &pek);
+    if (status) {
+        ret = status == -ENOMEM ? status : KMIP_FAILURE;
+        goto deinit;
+    }
+
+    ret = decrypt_meta_dek(meta, pek, dek_key);
+
+deinit:
+    sedcli_metadata_free_buffer(meta);
 
     return ret;
 }
@@ -748,7 +850,7 @@ static int programmatic_reset_enable(struct sed_device *sed_dev, const struct se
     int64_t val = strtol("1", NULL, 10);
     memcpy(col_info.data, &val, sizeof(int64_t));
 
-    uint8_t pre_uid[OPAL_UID_LENGTH] = {0, 0, 2, 1, 0, 3, 0, 1};
+    sed_uid_t pre_uid = 0x0000020100030001;
 
     int ret = sed_get_set_col_val(sed_dev, key, opal_uid[OPAL_ADMIN_SP_UID], opal_uid[OPAL_SID_UID], pre_uid, 8, false, &col_info);
     if (ret) {
@@ -807,7 +909,7 @@ static int programmatic_reset_enable(struct sed_device *sed_dev, const struct se
     memcpy(cmd + SET_CMD_START_LEN + item, cmd_end, sizeof(struct opal_req_item) * SET_CMD_END_LEN);
     size_t cmd_len = SET_CMD_START_LEN + SET_CMD_END_LEN + item;
 
-    uint8_t uid[OPAL_UID_LENGTH] = {0, 0, 8, 2, 0, 0, 0, 1};
+    sed_uid_t uid = opal_uid[OPAL_LOCKINGRANGE_GLOBAL_UID];
 
     return sed_set_with_buf(sed_dev, &key[0], opal_uid[OPAL_LOCKING_SP_UID], opal_uid[OPAL_ADMIN1_UID], uid, cmd, cmd_len);
 }
@@ -860,7 +962,7 @@ static int handle_get_lock_info(void)
         cols[last_col++] = col_info;
         memset(col_info, 0, sizeof(struct sed_opal_col_info));
 
-        uint8_t uid[OPAL_UID_LENGTH] = {0, 0, 8, 2, 0, 0, 0, 1};
+        sed_uid_t uid = opal_uid[OPAL_LOCKINGRANGE_GLOBAL_UID];
 
         ret = sed_get_set_col_val(sed_dev, &key[0], opal_uid[OPAL_LOCKING_SP_UID], opal_uid[OPAL_ADMIN1_UID], uid, i, true /* get */, col_info);
     }
@@ -887,13 +989,44 @@ cleanup:
 
 deinit:
     sed_deinit(sed_dev);
+    pek_cache_deinit();
 
     free(key);
 
     return ret;
 }
 
-static int handle_lock_unlock(void)
+/*
+ * State of lock-unlock for every device. The metadata lives in memory shared
+ * with the worker processes, so they can hand it back to the parent.
+ */
+struct lock_unlock_job {
+    uint8_t meta[SEDCLI_METADATA_SIZE];
+    struct pek_cache_entry *pek;
+    bool ok;
+};
+
+static struct lock_unlock_job *jobs;
+
+static int read_device_meta(uint8_t idx)
+{
+    struct sed_device *dev = NULL;
+    int ret = sed_init(&dev, dev_paths[idx], false);
+    if (ret) {
+        sedcli_printf(LOG_ERR, "Error in initializing the dev: %s\n", dev_paths[idx]);
+        return ret;
+    }
+
+    ret = sed_ds_read(dev, SED_ANYBODY, NULL, jobs[idx].meta, SEDCLI_METADATA_SIZE, 0);
+    if (ret)
+        sedcli_printf(LOG_ERR, "Can't read sedcli metadata from datastore.\n");
+
+    sed_deinit(dev);
+
+    return ret;
+}
+
+static int lock_unlock_device(uint8_t idx)
 {
     struct sed_key *dek = alloc_locked_buffer(sizeof(*dek));
     if (!dek) {
@@ -902,29 +1035,112 @@ static int handle_lock_unlock(void)
     }
 
     struct sed_device *dev = NULL;
-    int ret = sed_init(&dev, dev_path, false);
-    if (ret) {
-        sedcli_printf(LOG_ERR, "Error in initializing the dev: %s\n", dev_path);
-        goto deinit;
-    }
+    int ret = decrypt_meta_dek((struct sedcli_metadata *)jobs[idx].meta, jobs[idx].pek, dek);
+    if (ret)
+        goto free_dek;
 
-    int status = read_key_from_datastore(dev, dek);
-    if (status) {
-        sedcli_printf(LOG_ERR, "Error while decrypting DEK key.\n");
-        ret = KMIP_FAILURE;
-        goto deinit;
+    ret = sed_init(&dev, dev_paths[idx], false);
+    if (ret) {
+        sedcli_printf(LOG_ERR, "Error in initializing the dev: %s\n", dev_paths[idx]);
+        goto free_dek;
     }
 
     ret = sed_lock_unlock(dev, dek, opal_uid[OPAL_ADMIN1_UID], 0, false, opts->access_type);
     if (ret)
         sedcli_printf(LOG_ERR, "Error while unlocking drive.\n");
 
-deinit:
-    if (dek)
-        free_locked_buffer(dek, sizeof(*dek));
-
     sed_deinit(dev);
 
+free_dek:
+    free_locked_buffer(dek, sizeof(*dek));
+
+    return ret;
+}
+
+/*
+ * Run fn for every device still ok in its own child process, like harden in
+ * sedcli does, so the TPer sessions of all drives overlap. Devices fn fails
+ * on are no longer ok.
+ */
+static void run_per_device(int (*fn)(uint8_t idx))
+{
+    pid_t pids[MAX_SCAN_DEVS];
+
+    fflush(stdout);
+    fflush(stderr);
+
+    for (uint8_t i = 0; i < dev_count; i++) {
+        pids[i] = -1;
+        if (!jobs[i].ok)
+            continue;
+
+        pids[i] = fork();
+        if (pids[i] == 0) {
+            int ret = fn(i);
+            fflush(stdout);
+            exit(ret ? FAILURE : SUCCESS);
+        }
+
+        if (pids[i] == -1)
+            sedcli_printf(LOG_ERR, "%s: unable to spawn worker\n", dev_paths[i]);
+    }
+
+    for (uint8_t i = 0; i < dev_count; i++) {
+        if (!jobs[i].ok)
+            continue;
+
+        int status = 0;
+        if (pids[i] == -1 || waitpid(pids[i], &status, 0) == -1 ||
+            !WIFEXITED(status) || WEXITSTATUS(status) != SUCCESS)
+            jobs[i].ok = false;
+    }
+}
+
+/*
+ * The metadata of all drives is read in parallel, then every distinct PEK is
+ * retrieved once over a single KMIP connection, and finally all drives are
+ * unlocked in parallel.
+ */
+static int handle_lock_unlock(void)
+{
+    int ret = 0;
+
+    jobs = mmap(NULL, sizeof(*jobs) * dev_count, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (jobs == MAP_FAILED) {
+        sedcli_printf(LOG_ERR, "Failed to allocate memory.\n");
+        return -ENOMEM;
+    }
+
+    for (uint8_t i = 0; i < dev_count; i++)
+        jobs[i].ok = true;
+
+    run_per_device(read_device_meta);
+
+    for (uint8_t i = 0; i < dev_count; i++) {
+        if (!jobs[i].ok)
+            continue;
+
+        struct sedcli_metadata *meta = (struct sedcli_metadata *)jobs[i].meta;
+        int status = get_pek(sedcli_meta_get_pek_id_addr(meta), sedcli_meta_get_pek_id_size(meta), &jobs[i].pek);
+        if (status)
+            jobs[i].ok = false;
+    }
+
+    run_per_device(lock_unlock_device);
+
+    for (uint8_t i = 0; i < dev_count; i++) {
+        if (!jobs[i].ok) {
+            if (dev_count > 1)
+                sedcli_printf(LOG_ERR, "%s: failed\n", dev_paths[i]);
+            ret = KMIP_FAILURE;
+        }
+    }
+
+    memset(jobs, 0, sizeof(*jobs) * dev_count);
+    munmap(jobs, sizeof(*jobs) * dev_count);
+    jobs = NULL;
+    pek_cache_deinit();
+
     return ret;
 }
 
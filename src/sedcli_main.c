@@ -14,10 +14,12 @@
 #include <unistd.h>
 #include <ctype.h>
 #include <stdio.h>
+#include <time.h>
 
 #include <sys/syslog.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/wait.h>
 
 #include "libsed.h"
 #include "lib/nvme_pt_ioctl.h"
@@ -33,7 +35,7 @@
 
 extern sedcli_printf_t sedcli_printf;
 
-extern uint8_t opal_uid[][OPAL_UID_LENGTH];
+extern const sed_uid_t opal_uid[];
 
 static int host_prop_opts_parse(char *opt, char **arg);
 static int discovery_opts_parse(char *opt, char **arg);
@@ -48,6 +50,7 @@ static int set_password_opts_parse(char *opt, char **arg);
 static int mbr_control_opts_parse(char *opt, char **arg);
 static int write_mbr_opts_parse(char *opt, char **arg);
 static int block_sid_opts_parse(char *opt, char **arg);
+static int harden_opts_parse(char *opt, char **arg);
 static int add_user_lr_opts_parse(char *opt, char **arg);
 static int setup_lr_opts_parse(char *opt, char **arg);
 static int enable_user_opts_parse(char *opt, char **arg);
@@ -66,6 +69,8 @@ static int set_byte_table_opts_parse(char *opt, char **arg);
 static int get_acl_opts_parse(char *opt, char **arg);
 static int start_session_opts_parse(char *opt, char **arg);
 static int end_session_opts_parse(char *opt, char **arg);
+static int tune_opts_parse(char *opt, char **arg);
+static int state_opts_parse(char *opt, char **arg);
 
 static int host_prop_handle(void);
 static int discovery_handle(void);
@@ -82,6 +87,7 @@ static int set_password_handle(void);
 static int mbr_control_handle(void);
 static int write_mbr_handle(void);
 static int block_sid_handle(void);
+static int harden_handle(void);
 static int add_user_lr_handle(void);
 static int setup_lr_handle(void);
 static int enable_user_handle(void);
@@ -100,11 +106,18 @@ static int set_byte_table_handle(void);
 static int get_acl_handle(void);
 static int start_session_handle(void);
 static int end_session_handle(void);
+static int tune_handle(void);
+static int state_handle(void);
 
 static int read_password(struct sed_key *);
 
+#define MAX_HARDEN_DEVICES 64
+#define MAX_ENABLE_USERS 16
+
 #define D_DEVICE_PARAM_REQUIRED \
     {'d', "device", "Device node e.g. /dev/nvme0n1", 1, "DEVICE", CLI_OPTION_REQUIRED}
+#define D_DEVICES_PARAM_REQUIRED \
+    {'d', "device", "Device nodes separated by a space e.g. /dev/nvme0n1 /dev/nvme1n1", MAX_HARDEN_DEVICES, "DEVICE", CLI_OPTION_REQUIRED}
 #define F_FORMAT_PARAM_OPTIONAL \
     {'f', "format", "Output format: normal/udev", 1, "FMT", CLI_OPTION_OPTIONAL}
 #define A_AUTHORITY_PARAM_REQUIRED \
@@ -157,6 +170,9 @@ static int read_password(struct sed_key *);
     {'w', "where", "Row to begin in UID format: 00-01-02-03-04-05-06-07", 1, "FMT", CLI_OPTION_OPTIONAL}
 #define C_COUNT_PARAM_OPTIONAL \
     {'c', "count", "Number of rows to iterate through.", 1, "NUM", CLI_OPTION_OPTIONAL}
+
+#define L_ALL_ROWS_PARAM_OPTIONAL \
+    {'l', "all", "Page through all rows of the table within one session, count rows at a time", 0, "FLAG", CLI_OPTION_OPTIONAL}
 #define S_START_PARAM_REQUIRED \
     {'s', "start", "Number of row/column to start with", 1, "NUM", CLI_OPTION_REQUIRED}
 #define E_END_PARAM_REQUIRED \
@@ -295,6 +311,13 @@ static cli_option block_sid_opts[] = {
     {0}
 };
 
+static cli_option harden_opts[] = {
+    D_DEVICES_PARAM_REQUIRED,
+    R_HWRESET_PARAM_REQUIRED,
+    M_MBR_DONE_PARAM_OPTIONAL,
+    {0}
+};
+
 static cli_option add_user_lr_opts[] = {
     D_DEVICE_PARAM_REQUIRED,
     A_AUTHORITY_PARAM_REQUIRED,
@@ -337,7 +360,8 @@ static cli_option enable_user_opts[] = {
     D_DEVICE_PARAM_REQUIRED,
     P_SP_PARAM_REQUIRED,
     A_AUTHORITY_PARAM_REQUIRED,
-    U_USER_PARAM_REQUIRED,
+    {'u', "user", "Users separated by a space, can be in UID format: 00-01-02-03-04-05-06-07", MAX_ENABLE_USERS, "FMT", CLI_OPTION_REQUIRED},
+    {'n', "new-password", "Set a new password for every user and verify it in the same session", 0, "FLAG", CLI_OPTION_OPTIONAL},
     {0}
 };
 
@@ -367,6 +391,7 @@ static cli_option table_next_opts[] = {
     I_UID_PARAM_REQUIRED,
     W_WHERE_PARAM_OPTIONAL,
     C_COUNT_PARAM_OPTIONAL,
+    L_ALL_ROWS_PARAM_OPTIONAL,
     {0}
 };
 
@@ -460,6 +485,16 @@ static cli_option end_session_opts[] = {
     {0}
 };
 
+static cli_option tune_opts[] = {
+    D_DEVICE_PARAM_REQUIRED,
+    {0}
+};
+
+static cli_option state_opts[] = {
+    D_DEVICE_PARAM_REQUIRED,
+    {0}
+};
+
 #define CMD_OPTS(function) function ## _opts
 #define CMD_OPTS_PARSE(function) function ## _opts_parse
 #define CMD_HANDLE(function) function ## _handle
@@ -562,6 +597,13 @@ static cli_command sedcli_commands[] = {
         .long_desc = "Issue Block SID authentication command.",
         CMD_FN_PTRS(block_sid)
     },
+    {
+        .name = "harden",
+        .desc = "Issue Block SID and optionally set MBR Done on several devices in parallel.",
+        .long_desc = "Post-boot hardening: issue Block SID authentication command to all given devices concurrently,\n"
+                     "   optionally followed by setting MBR Done with Admin1 authority, and report completion time.",
+        CMD_FN_PTRS(harden)
+    },
     {
         .name = "add-user-to-lr",
         .desc = "Add users to the Locking Ranges.",
@@ -589,7 +631,8 @@ static cli_command sedcli_commands[] = {
     {
         .name = "enable-user",
         .desc = "Enable users for Locking Ranges.",
-        .long_desc = "Enable users for Locking Ranges.",
+        .long_desc = "Enable users for Locking Ranges. All given users are enabled within one session; with\n"
+            "new-password each user also gets a new password, verified by authenticating the user in that session.",
         CMD_FN_PTRS(enable_user)
     },
     {
@@ -607,7 +650,8 @@ static cli_command sedcli_commands[] = {
     {
         .name = "table-next",
         .desc = "Iterate through an object table.",
-        .long_desc = "Iterate through an object table.",
+        .long_desc = "Iterate through an object table. With --all every row of the table is listed, "
+            "fetched --count rows at a time within a single session.",
         CMD_FN_PTRS(table_next)
     },
     {
@@ -658,6 +702,20 @@ static cli_command sedcli_commands[] = {
         .long_desc = "Set Byte Table.",
         CMD_FN_PTRS(set_byte_table)
     },
+    {
+        .name = "tune",
+        .desc = "Measure the device and store its performance profile.",
+        .long_desc = "Measure the device using read-only operations and store the resulting performance profile\n"
+                     "   for its model and firmware, the profile is applied every time the device is opened.",
+        CMD_FN_PTRS(tune)
+    },
+    {
+        .name = "state",
+        .desc = "Print the last known state of the device.",
+        .long_desc = "Print the state last published by sedcli for the device from the shared state table,\n"
+                     "   without accessing the device.",
+        CMD_FN_PTRS(state)
+    },
     {
         .name = "version",
         .desc = "Print sedcli version.",
@@ -702,27 +760,28 @@ struct sedcli_options {
     char lr_str[1024];
 
     char auth[MAX_STRING]; /* User{1..9} or Admin1 */
-    uint8_t auth_uid[OPAL_UID_LENGTH];
+    sed_uid_t auth_uid;
     bool auth_is_uid;
 
     char user[MAX_STRING]; /* User{1..9} or Admin1 */
-    uint8_t user_uid[OPAL_UID_LENGTH];
+    sed_uid_t user_uid;
     bool user_is_uid;
 
     enum SED_SP_TYPE sp;
-    uint8_t sp_uid[OPAL_UID_LENGTH];
+    sed_uid_t sp_uid;
     enum SED_SP_TYPE target_sp;
-    uint8_t target_sp_uid[OPAL_UID_LENGTH];
+    sed_uid_t target_sp_uid;
 
     char props[NUM_HOST_PROPS][MAX_PROP_NAME_LEN];
     uint32_t values[NUM_HOST_PROPS];
     uint64_t range_length;
     uint64_t range_start;
     uint32_t nsid;
-    uint8_t uid[OPAL_UID_LENGTH];
-    uint8_t method[OPAL_UID_LENGTH];
-    uint8_t where[OPAL_UID_LENGTH];
+    sed_uid_t uid;
+    sed_uid_t method;
+    sed_uid_t where;
     uint16_t count;
+    bool all_rows;
     uint64_t start;
     uint64_t end;
     uint8_t type;
@@ -761,7 +820,7 @@ enum sed_print_flags val_output_fmt(const char *fmt)
     return -EINVAL;
 }
 
-int sp_param_handle(char **arg, uint8_t *sp_uid, enum SED_SP_TYPE *target_sp)
+int sp_param_handle(char **arg, sed_uid_t *sp_uid, enum SED_SP_TYPE *target_sp)
 {
     if (!strncmp(arg[0], "admin_sp", MAX_INPUT)) {
         *target_sp = SED_ADMIN_SP;
@@ -784,7 +843,7 @@ int sp_param_handle(char **arg, uint8_t *sp_uid, enum SED_SP_TYPE *target_sp)
 
 void authority_param_handle(char **arg)
 {
-    if (parse_uid(arg, opts->auth_uid))
+    if (parse_uid(arg, &opts->auth_uid))
         opts->auth_is_uid = true;
     else {
         strncpy(opts->auth, arg[0], sizeof(opts->auth) - 1);
@@ -795,7 +854,7 @@ void authority_param_handle(char **arg)
 
 void user_param_handle(char **arg)
 {
-    if (parse_uid(arg, opts->user_uid))
+    if (parse_uid(arg, &opts->user_uid))
         opts->user_is_uid = true;
     else {
         strncpy(opts->user, arg[0], sizeof(opts->user) - 1);
@@ -893,10 +952,10 @@ int activate_sp_opts_parse(char *opt, char **arg)
     } else if (!strncmp(opt, "authority", MAX_INPUT)) {
         authority_param_handle(arg);
     } else if (!strncmp(opt, "sp", MAX_INPUT)) {
-        if (sp_param_handle(arg, opts->sp_uid, &opts->sp) != SED_SUCCESS)
+        if (sp_param_handle(arg, &opts->sp_uid, &opts->sp) != SED_SUCCESS)
             goto err_parsing;
     } else if (!strncmp(opt, "target-sp", MAX_INPUT)) {
-        if (sp_param_handle(arg, opts->target_sp_uid, &opts->target_sp) != SED_SUCCESS)
+        if (sp_param_handle(arg, &opts->target_sp_uid, &opts->target_sp) != SED_SUCCESS)
             goto err_parsing;
         target_sp = true;
     }  else if (!strncmp(opt, "locking-ranges", MAX_INPUT)) {
@@ -932,10 +991,10 @@ int revert_opts_parse(char *opt, char **arg)
     } else if (!strncmp(opt, "authority", MAX_INPUT)) {
         authority_param_handle(arg);
     } else if (!strncmp(opt, "sp", MAX_INPUT)) {
-        if (sp_param_handle(arg, opts->sp_uid, &opts->sp) != SED_SUCCESS)
+        if (sp_param_handle(arg, &opts->sp_uid, &opts->sp) != SED_SUCCESS)
             goto err_parsing;
     } else if (!strncmp(opt, "target-sp", MAX_INPUT)) {
-        if (sp_param_handle(arg, opts->target_sp_uid, &opts->target_sp) != SED_SUCCESS)
+        if (sp_param_handle(arg, &opts->target_sp_uid, &opts->target_sp) != SED_SUCCESS)
             goto err_parsing;
         target_sp = true;
     }
@@ -1021,7 +1080,7 @@ int set_password_opts_parse(char *opt, char **arg)
     if (!strncmp(opt, "device", MAX_INPUT)) {
         strncpy(opts->dev_path, arg[0], PATH_MAX - 1);
     } else if (!strncmp(opt, "sp", MAX_INPUT)) {
-        if (sp_param_handle(arg, opts->sp_uid, &opts->sp) != SED_SUCCESS)
+        if (sp_param_handle(arg, &opts->sp_uid, &opts->sp) != SED_SUCCESS)
             goto err_parsing;
     } else if (!strncmp(opt, "authority", MAX_INPUT)) {
         authority_param_handle(arg);
@@ -1116,6 +1175,31 @@ int block_sid_opts_parse(char *opt, char **arg)
     return 0;
 }
 
+static char harden_dev_paths[MAX_HARDEN_DEVICES][PATH_MAX];
+static uint8_t harden_dev_count = 0;
+int harden_opts_parse(char *opt, char **arg)
+{
+    if (!strncmp(opt, "device", MAX_INPUT)) {
+        for (uint8_t i = 0; arg[i] != NULL; i++) {
+            if (harden_dev_count >= MAX_HARDEN_DEVICES) {
+                sedcli_printf(LOG_ERR, "Too many devices provided.\n");
+                return -EINVAL;
+            }
+
+            strncpy(harden_dev_paths[harden_dev_count++], arg[i], PATH_MAX - 1);
+        }
+    } else if (!strncmp(opt, "hwreset", MAX_INPUT)) {
+        return block_sid_opts_parse(opt, arg);
+    } else if (!strncmp(opt, "done", MAX_INPUT)) {
+        mbr_done = true;
+        opts->done = get_mbr_flag(arg[0]);
+        if (opts->done < 0)
+            return opts->done;
+    }
+
+    return 0;
+}
+
 int add_user_lr_opts_parse(char *opt, char **arg)
 {
     char *error;
@@ -1151,10 +1235,10 @@ int setup_lr_opts_parse(char *opt, char **arg)
     } else if (!strncmp(opt, "authority", MAX_INPUT)) {
         authority_param_handle(arg);
     } else if (!strncmp(opt, "sp", MAX_INPUT)) {
-        if (sp_param_handle(arg, opts->sp_uid, &opts->sp) != SED_SUCCESS)
+        if (sp_param_handle(arg, &opts->sp_uid, &opts->sp) != SED_SUCCESS)
             goto err_parsing;
     } else if (!strncmp(opt, "locking-range", MAX_INPUT)) {
-        if (parse_uid(arg, opts->uid) == false)
+        if (parse_uid(arg, &opts->uid) == false)
             goto err_parsing;
     } else if (!strncmp(opt, "rle", MAX_INPUT)) {
         if (arg[0] == NULL)
@@ -1200,10 +1284,10 @@ int genkey_opts_parse(char *opt, char **arg)
     } else if (!strncmp(opt, "authority", MAX_INPUT)) {
         authority_param_handle(arg);
     } else if (!strncmp(opt, "sp", MAX_INPUT)) {
-        if (sp_param_handle(arg, opts->sp_uid, &opts->sp) != SED_SUCCESS)
+        if (sp_param_handle(arg, &opts->sp_uid, &opts->sp) != SED_SUCCESS)
             goto err_parsing;
     } else if (!strncmp(opt, "uid", MAX_INPUT)) {
-        if (parse_uid(arg, opts->uid) == false)
+        if (parse_uid(arg, &opts->uid) == false)
             goto err_parsing;
     } else if (!strncmp(opt, "public-exponent", MAX_INPUT)) {
         opts->public_exponent = strtoul(arg[0], &error, 10);
@@ -1229,10 +1313,10 @@ int erase_opts_parse(char *opt, char **arg)
     } else if (!strncmp(opt, "authority", MAX_INPUT)) {
         authority_param_handle(arg);
     } else if (!strncmp(opt, "sp", MAX_INPUT)) {
-        if (sp_param_handle(arg, opts->sp_uid, &opts->sp) != SED_SUCCESS)
+        if (sp_param_handle(arg, &opts->sp_uid, &opts->sp) != SED_SUCCESS)
             goto err_parsing;
     } else if (!strncmp(opt, "locking-range", MAX_INPUT)) {
-        if (parse_uid(arg, opts->uid) == false)
+        if (parse_uid(arg, &opts->uid) == false)
             goto err_parsing;
     }
 
@@ -1243,6 +1327,9 @@ err_parsing:
     return -EINVAL;
 }
 
+static sed_uid_t enable_user_uids[MAX_ENABLE_USERS];
+static uint8_t enable_user_count = 0;
+static bool enable_user_new_pwd = false;
 int enable_user_opts_parse(char *opt, char **arg)
 {
     if (!strncmp(opt, "device", MAX_INPUT)) {
@@ -1250,10 +1337,21 @@ int enable_user_opts_parse(char *opt, char **arg)
     } else if (!strncmp(opt, "authority", MAX_INPUT)) {
         authority_param_handle(arg);
     } else if (!strncmp(opt, "sp", MAX_INPUT)) {
-        if (sp_param_handle(arg, opts->sp_uid, &opts->sp) != SED_SUCCESS)
+        if (sp_param_handle(arg, &opts->sp_uid, &opts->sp) != SED_SUCCESS)
             goto err_parsing;
     } else if (!strncmp(opt, "user", MAX_INPUT)) {
-        user_param_handle(arg);
+        for (uint8_t i = 0; arg[i] != NULL; i++) {
+            if (enable_user_count >= MAX_ENABLE_USERS) {
+                sedcli_printf(LOG_ERR, "Too many users provided.\n");
+                return -EINVAL;
+            }
+
+            sed_uid_t *uid = &enable_user_uids[enable_user_count++];
+            if (parse_uid(&arg[i], uid) == false && get_opal_user_auth_uid(arg[i], false, uid) != SED_SUCCESS)
+                goto err_parsing;
+        }
+    } else if (!strncmp(opt, "new-password", MAX_INPUT)) {
+        enable_user_new_pwd = true;
     }
 
     return 0;
@@ -1272,7 +1370,7 @@ int assign_opts_parse(char *opt, char **arg)
     } else if (!strncmp(opt, "authority", MAX_INPUT)) {
         authority_param_handle(arg);
     } else if (!strncmp(opt, "sp", MAX_INPUT)) {
-        if (sp_param_handle(arg, opts->sp_uid, &opts->sp) != SED_SUCCESS)
+        if (sp_param_handle(arg, &opts->sp_uid, &opts->sp) != SED_SUCCESS)
             goto err_parsing;
     } else if (!strncmp(opt, "namespace", MAX_INPUT)) {
         opts->nsid = strtoul(arg[0], &error, 10);
@@ -1302,10 +1400,10 @@ int deassign_opts_parse(char *opt, char **arg)
     } else if (!strncmp(opt, "authority", MAX_INPUT)) {
         authority_param_handle(arg);
     } else if (!strncmp(opt, "sp", MAX_INPUT)) {
-        if (sp_param_handle(arg, opts->sp_uid, &opts->sp) != SED_SUCCESS)
+        if (sp_param_handle(arg, &opts->sp_uid, &opts->sp) != SED_SUCCESS)
             goto err_parsing;
     } else if (!strncmp(opt, "uid", MAX_INPUT)) {
-        if (parse_uid(arg, opts->uid) == false)
+        if (parse_uid(arg, &opts->uid) == false)
             goto err_parsing;
     } else if (!strncmp(opt, "keep-ns-global-range-key", MAX_INPUT)) {
         opts->keep_ns_global_range_key = true;
@@ -1325,16 +1423,18 @@ int table_next_opts_parse(char *opt, char **arg)
     } else if (!strncmp(opt, "authority", MAX_INPUT)) {
         authority_param_handle(arg);
     } else if (!strncmp(opt, "sp", MAX_INPUT)) {
-        if (sp_param_handle(arg, opts->sp_uid, &opts->sp) != SED_SUCCESS)
+        if (sp_param_handle(arg, &opts->sp_uid, &opts->sp) != SED_SUCCESS)
             goto err_parsing;
     } else if (!strncmp(opt, "uid", MAX_INPUT)) {
-        if (parse_uid(arg, opts->uid) == false)
+        if (parse_uid(arg, &opts->uid) == false)
             goto err_parsing;
     } else if (!strncmp(opt, "where", MAX_INPUT)) {
-        if (parse_uid(arg, opts->where) == false)
+        if (parse_uid(arg, &opts->where) == false)
             goto err_parsing;
     } else if (!strncmp(opt, "count", MAX_INPUT)) {
         opts->count = strtol(arg[0], NULL, 10);
+    } else if (!strncmp(opt, "all", MAX_INPUT)) {
+        opts->all_rows = true;
     }
 
     return 0;
@@ -1360,10 +1460,10 @@ int reactivate_sp_opts_parse(char *opt, char **arg)
     } else if (!strncmp(opt, "authority", MAX_INPUT)) {
         authority_param_handle(arg);
     } else if (!strncmp(opt, "sp", MAX_INPUT)) {
-        if (sp_param_handle(arg, opts->sp_uid, &opts->sp) != SED_SUCCESS)
+        if (sp_param_handle(arg, &opts->sp_uid, &opts->sp) != SED_SUCCESS)
             goto err_parsing;
     } else if (!strncmp(opt, "target-sp", MAX_INPUT)) {
-        if (sp_param_handle(arg, opts->target_sp_uid, &opts->target_sp) != SED_SUCCESS)
+        if (sp_param_handle(arg, &opts->target_sp_uid, &opts->target_sp) != SED_SUCCESS)
             goto err_parsing;
         target_sp = true;
     }  else if (!strncmp(opt, "locking-ranges", MAX_INPUT)) {
@@ -1409,12 +1509,12 @@ int get_object_opts_parse(char *opt, char **arg)
     if (!strncmp(opt, "device", MAX_INPUT)) {
         strncpy(opts->dev_path, arg[0], PATH_MAX - 1);
     } else if (!strncmp(opt, "sp", MAX_INPUT)) {
-        if (sp_param_handle(arg, opts->sp_uid, &opts->sp) != SED_SUCCESS)
+        if (sp_param_handle(arg, &opts->sp_uid, &opts->sp) != SED_SUCCESS)
             goto err_parsing;
     } else if (!strncmp(opt, "authority", MAX_INPUT)) {
         authority_param_handle(arg);
     } else if (!strncmp(opt, "uid", MAX_INPUT)) {
-        if (parse_uid(arg, opts->uid) == false)
+        if (parse_uid(arg, &opts->uid) == false)
             goto err_parsing;
     } else if (!strncmp(opt, "start", MAX_INPUT)) {
         if (parse_int_or_hex(arg, &opts->start))
@@ -1436,16 +1536,16 @@ int get_acl_opts_parse(char *opt, char **arg)
     if (!strncmp(opt, "device", MAX_INPUT)) {
         strncpy(opts->dev_path, arg[0], PATH_MAX - 1);
     } else if (!strncmp(opt, "sp", MAX_INPUT)) {
-        if (sp_param_handle(arg, opts->sp_uid, &opts->sp) != SED_SUCCESS)
+        if (sp_param_handle(arg, &opts->sp_uid, &opts->sp) != SED_SUCCESS)
             goto err_parsing;
     } else if (!strncmp(opt, "authority", MAX_INPUT)) {
         authority_param_handle(arg);
     } else if (!strncmp(opt, "invoking-uid", MAX_INPUT)) {
-        if (parse_uid(arg, opts->uid) == false)
+        if (parse_uid(arg, &opts->uid) == false)
             goto err_parsing;
     }
     else if (!strncmp(opt, "method-uid", MAX_INPUT)) {
-        if (parse_uid(arg, opts->method) == false)
+        if (parse_uid(arg, &opts->method) == false)
             goto err_parsing;
     }
     return 0;
@@ -1460,12 +1560,12 @@ int set_object_opts_parse(char *opt, char **arg)
     if (!strncmp(opt, "device", MAX_INPUT)) {
         strncpy(opts->dev_path, arg[0], PATH_MAX - 1);
     } else if (!strncmp(opt, "sp", MAX_INPUT)) {
-        if (sp_param_handle(arg, opts->sp_uid, &opts->sp) != SED_SUCCESS)
+        if (sp_param_handle(arg, &opts->sp_uid, &opts->sp) != SED_SUCCESS)
             goto err_parsing;
     } else if (!strncmp(opt, "authority", MAX_INPUT)) {
         authority_param_handle(arg);
     } else if (!strncmp(opt, "uid", MAX_INPUT)) {
-        if (parse_uid(arg, opts->uid) == false)
+        if (parse_uid(arg, &opts->uid) == false)
             goto err_parsing;
     } else if (!strncmp(opt, "row", MAX_INPUT)) {
         opts->row = strtoul(arg[0], NULL, 10);
@@ -1526,7 +1626,7 @@ int start_session_opts_parse(char *opt, char **arg)
     if (!strncmp(opt, "device", MAX_INPUT)) {
         strncpy(opts->dev_path, arg[0], PATH_MAX - 1);
     } else if (!strncmp(opt, "sp", MAX_INPUT)) {
-        if (sp_param_handle(arg, opts->sp_uid, &opts->sp) != SED_SUCCESS)
+        if (sp_param_handle(arg, &opts->sp_uid, &opts->sp) != SED_SUCCESS)
             goto err_parsing;
     } else if (!strncmp(opt, "authority", MAX_INPUT)) {
         authority_param_handle(arg);
@@ -1560,6 +1660,22 @@ err_parsing:
     return -EINVAL;
 }
 
+int tune_opts_parse(char *opt, char **arg)
+{
+    if (!strncmp(opt, "device", MAX_INPUT))
+        strncpy(opts->dev_path, arg[0], PATH_MAX - 1);
+
+    return 0;
+}
+
+int state_opts_parse(char *opt, char **arg)
+{
+    if (!strncmp(opt, "device", MAX_INPUT))
+        strncpy(opts->dev_path, arg[0], PATH_MAX - 1);
+
+    return 0;
+}
+
 int get_byte_table_opts_parse(char *opt, char **arg)
 {
     if (!strncmp(opt, "device", MAX_INPUT)) {
@@ -1575,7 +1691,7 @@ int get_byte_table_opts_parse(char *opt, char **arg)
         strncpy(opts->auth, arg[0], sizeof(opts->auth) - 1);
         opts->auth[sizeof(opts->auth) - 1] = '\0';
     } else if (!strncmp(opt, "uid", MAX_INPUT)) {
-        if (parse_uid(arg, opts->uid) == false)
+        if (parse_uid(arg, &opts->uid) == false)
             goto err_parsing;
     } else if (!strncmp(opt, "start", MAX_INPUT)) {
         if (parse_int_or_hex(arg, &opts->start))
@@ -1607,7 +1723,7 @@ int set_byte_table_opts_parse(char *opt, char **arg)
         strncpy(opts->auth, arg[0], sizeof(opts->auth) - 1);
         opts->auth[sizeof(opts->auth) - 1] = '\0';
     } else if (!strncmp(opt, "uid", MAX_INPUT)) {
-        if (parse_uid(arg, opts->uid) == false)
+        if (parse_uid(arg, &opts->uid) == false)
             goto err_parsing;
     } else if (!strncmp(opt, "start", MAX_INPUT)) {
         if (parse_int_or_hex(arg, &opts->start))
@@ -2151,15 +2267,15 @@ static int activate_sp_handle(void)
     if (ret)
         goto deinit;
 
-    ret = get_opal_sp_uid(opts->sp, opts->sp_uid);
+    ret = get_opal_sp_uid(opts->sp, &opts->sp_uid);
     if (ret)
         goto deinit;
 
-    ret = get_opal_sp_uid(opts->target_sp, opts->target_sp_uid);
+    ret = get_opal_sp_uid(opts->target_sp, &opts->target_sp_uid);
     if (ret)
         goto deinit;
 
-    ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, opts->auth_uid);
+    ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, &opts->auth_uid);
     if (ret)
         goto deinit;
 
@@ -2184,15 +2300,15 @@ static int start_session_handle(void)
     if (ret)
         goto deinit;
 
-    ret = get_opal_sp_uid(opts->sp, opts->sp_uid);
+    ret = get_opal_sp_uid(opts->sp, &opts->sp_uid);
     if (ret)
         goto deinit;
 
-    ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, opts->auth_uid);
+    ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, &opts->auth_uid);
     if (ret)
         goto deinit;
 
-    ret = get_opal_sp_uid(opts->target_sp, opts->target_sp_uid);
+    ret = get_opal_sp_uid(opts->target_sp, &opts->target_sp_uid);
     if (ret)
         goto deinit;
 
@@ -2223,6 +2339,60 @@ static int end_session_handle(void)
     return ret;
 }
 
+static int tune_handle(void)
+{
+    struct sed_device *dev = NULL;
+    int ret = sed_init(&dev, opts->dev_path, false);
+    if (ret)
+        return ret;
+
+    struct sed_profile profile;
+    ret = sed_tune_profile(dev, &profile, true);
+    if (ret == SED_SUCCESS) {
+        sedcli_printf(LOG_INFO, "Poll interval     : %u us\n", profile.poll_interval);
+        sedcli_printf(LOG_INFO, "Max read table    : %u\n", profile.max_read_table);
+        sedcli_printf(LOG_INFO, "Min IO buffer len : %u\n", profile.min_io_buf_len);
+    }
+
+    sed_deinit(dev);
+
+    return ret;
+}
+
+static int state_handle(void)
+{
+    struct sed_state state;
+    int ret = sed_get_state(opts->dev_path, &state);
+    if (ret == -ENOENT) {
+        sedcli_printf(LOG_ERR, "No state published for %s\n", opts->dev_path);
+        return ret;
+    }
+
+    if (ret)
+        return ret;
+
+    sedcli_printf(LOG_INFO, "Locking enabled   : %s\n", state.locking.locking_en ? "Y" : "N");
+    sedcli_printf(LOG_INFO, "Locked            : %s\n", state.locking.locked ? "Y" : "N");
+    sedcli_printf(LOG_INFO, "MBR enabled       : %s\n", state.locking.mbr_en ? "Y" : "N");
+    sedcli_printf(LOG_INFO, "MBR done          : %s\n", state.locking.mbr_done ? "Y" : "N");
+
+    for (uint8_t i = 0; i < SED_OPAL_MAX_LRS; i++) {
+        if (!(state.lr_known & (1 << i)))
+            continue;
+
+        sedcli_printf(LOG_INFO, "Locking range %u   : read %s, write %s\n", i,
+            state.lr_read_locked & (1 << i) ? "locked" : "unlocked",
+            state.lr_write_locked & (1 << i) ? "locked" : "unlocked");
+    }
+
+    time_t updated = state.updated;
+    sedcli_printf(LOG_INFO, "Last error        : %d\n", state.last_error);
+    sedcli_printf(LOG_INFO, "Last op latency   : %u us\n", state.last_op_latency);
+    sedcli_printf(LOG_INFO, "Updated           : %s", ctime(&updated));
+
+    return SUCCESS;
+}
+
 static int revert_handle(void)
 {
     struct sed_device *dev = NULL;
@@ -2235,15 +2405,15 @@ static int revert_handle(void)
     if (ret)
         goto deinit;
 
-    ret = get_opal_sp_uid(opts->sp, opts->sp_uid);
+    ret = get_opal_sp_uid(opts->sp, &opts->sp_uid);
     if (ret)
         goto deinit;
 
-    ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, opts->auth_uid);
+    ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, &opts->auth_uid);
     if (ret)
         goto deinit;
 
-    ret = get_opal_sp_uid(opts->target_sp, opts->target_sp_uid);
+    ret = get_opal_sp_uid(opts->target_sp, &opts->target_sp_uid);
     if (ret)
         goto deinit;
 
@@ -2267,7 +2437,7 @@ static int revert_lsp_handle(void)
     if (ret)
         goto deinit;
 
-    ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, opts->auth_uid);
+    ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, &opts->auth_uid);
     if (ret)
         goto deinit;
 
@@ -2291,7 +2461,7 @@ static int lock_unlock_handle(void)
     if (ret)
         goto deinit;
 
-    ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, opts->auth_uid);
+    ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, &opts->auth_uid);
     if (ret)
         goto deinit;
 
@@ -2337,11 +2507,11 @@ static int setup_lr_handle(void)
     if (ret)
         goto deinit;
 
-    ret = get_opal_sp_uid(opts->sp, opts->sp_uid);
+    ret = get_opal_sp_uid(opts->sp, &opts->sp_uid);
     if (ret)
         goto deinit;
 
-    ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, opts->auth_uid);
+    ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, &opts->auth_uid);
     if (ret)
         goto deinit;
 
@@ -2365,11 +2535,11 @@ static int genkey_handle(void)
     if (ret)
         goto deinit;
 
-    ret = get_opal_sp_uid(opts->sp, opts->sp_uid);
+    ret = get_opal_sp_uid(opts->sp, &opts->sp_uid);
     if (ret)
         goto deinit;
 
-    ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, opts->auth_uid);
+    ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, &opts->auth_uid);
     if (ret)
         goto deinit;
 
@@ -2393,11 +2563,11 @@ static int erase_handle(void)
     if (ret)
         goto deinit;
 
-    ret = get_opal_sp_uid(opts->sp, opts->sp_uid);
+    ret = get_opal_sp_uid(opts->sp, &opts->sp_uid);
     if (ret)
         goto deinit;
 
-    ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, opts->auth_uid);
+    ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, &opts->auth_uid);
     if (ret)
         goto deinit;
 
@@ -2421,19 +2591,36 @@ static int enable_user_handle(void)
     if (ret)
         goto deinit;
 
-    ret = get_opal_sp_uid(opts->sp, opts->sp_uid);
+    ret = get_opal_sp_uid(opts->sp, &opts->sp_uid);
     if (ret)
         goto deinit;
 
-    ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, opts->auth_uid);
+    ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, &opts->auth_uid);
     if (ret)
         goto deinit;
 
-    ret = get_opal_user_auth_uid(opts->user, opts->user_is_uid, opts->user_uid);
-    if (ret)
-        goto deinit;
+    struct sed_key user_keys[MAX_ENABLE_USERS];
+    for (uint8_t i = 0; enable_user_new_pwd && i < enable_user_count; i++) {
+        sedcli_printf(LOG_INFO, "New password for user %u:", i + 1);
+        ret = read_password(&user_keys[i]);
+        if (ret)
+            goto deinit;
+
+        sedcli_printf(LOG_INFO, "Repeat new password for user %u:", i + 1);
+        struct sed_key repeated = { 0 };
+        ret = read_password(&repeated);
+        if (ret)
+            goto deinit;
+
+        if (user_keys[i].len != repeated.len || memcmp(user_keys[i].key, repeated.key, repeated.len)) {
+            sedcli_printf(LOG_ERR, "Error: passwords don't match\n");
+            ret = -EINVAL;
+            goto deinit;
+        }
+    }
 
-    ret = sed_enable_user(dev, &opts->pwd, opts->sp_uid, opts->auth_uid, opts->user_uid);
+    ret = sed_enable_users(dev, &opts->pwd, opts->sp_uid, opts->auth_uid, enable_user_uids,
+        enable_user_new_pwd ? user_keys : NULL, enable_user_count);
 
 deinit:
     sed_deinit(dev);
@@ -2573,11 +2760,11 @@ static int get_object_handle(void)
     if (ret)
         goto deinit;
 
-    ret = get_opal_sp_uid(opts->sp, opts->sp_uid);
+    ret = get_opal_sp_uid(opts->sp, &opts->sp_uid);
     if (ret)
         goto deinit;
 
-    ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, opts->auth_uid);
+    ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, &opts->auth_uid);
     if (ret)
         goto deinit;
 
@@ -2711,11 +2898,11 @@ static int set_buff(struct sed_device *dev)
     memcpy(cmd + SET_CMD_START_LEN + item, cmd_end, sizeof(struct opal_req_item) * SET_CMD_END_LEN);
     size_t cmd_len = SET_CMD_START_LEN + SET_CMD_END_LEN + item;
 
-    int ret = get_opal_sp_uid(opts->sp, opts->sp_uid);
+    int ret = get_opal_sp_uid(opts->sp, &opts->sp_uid);
     if (ret)
         return ret;
 
-    ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, opts->auth_uid);
+    ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, &opts->auth_uid);
     if (ret)
         return ret;
 
@@ -2770,11 +2957,11 @@ static int set_object_handle(void)
             goto cleanup;
         }
 
-        ret = get_opal_sp_uid(opts->sp, opts->sp_uid);
+        ret = get_opal_sp_uid(opts->sp, &opts->sp_uid);
         if (ret)
             goto cleanup;
 
-        ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, opts->auth_uid);
+        ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, &opts->auth_uid);
         if (ret)
             goto cleanup;
 
@@ -2865,12 +3052,8 @@ static int byte_table_handle(bool is_set)
         goto deinit;
 
     size_t buffer_size = sizeof(uint8_t) * (opts->end - opts->start + 1);
-
-    uint8_t *buffer = calloc((opts->end - opts->start + 1), sizeof(uint8_t));
-    if (buffer == NULL) {
-        ret = -ENOMEM;
-        goto deinit;
-    }
+    uint8_t *buffer = NULL;
+    void *file_mmap = MAP_FAILED;
 
     // open file and get size
     if (is_set)
@@ -2895,17 +3078,41 @@ static int byte_table_handle(bool is_set)
         if (buffer_size < file_size)
             sedcli_printf(LOG_WARNING, "Error size of given file is greater than requested num of rows: %s\n", opts->file_path);
 
-        // read file to buffer
-        ret = read(fd, buffer, buffer_size);
-        if (ret < 0)
-        {
-            sedcli_printf(LOG_ERR, "Error during reading file: %s\n", opts->file_path);
-            close(fd);
-            ret = -EINVAL;
-            goto cleanup;
+        // map the file and hand its pages to the library, the buffer is not
+        // const in sed_get_set_byte_table, so writes go to private copies
+        if (file_size >= buffer_size) {
+            file_mmap = mmap(NULL, buffer_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            if (file_mmap != MAP_FAILED)
+                buffer = file_mmap;
+        }
+
+        // short files are padded with zeroes, pipes can't be mapped
+        if (buffer == NULL) {
+            buffer = calloc(buffer_size, sizeof(uint8_t));
+            if (buffer == NULL) {
+                close(fd);
+                ret = -ENOMEM;
+                goto deinit;
+            }
+
+            // read file to buffer
+            ret = read(fd, buffer, buffer_size);
+            if (ret < 0)
+            {
+                sedcli_printf(LOG_ERR, "Error during reading file: %s\n", opts->file_path);
+                close(fd);
+                ret = -EINVAL;
+                goto cleanup;
+            }
         }
 
         close(fd);
+    } else {
+        buffer = calloc(buffer_size, sizeof(uint8_t));
+        if (buffer == NULL) {
+            ret = -ENOMEM;
+            goto deinit;
+        }
     }
 
     ret = sed_get_set_byte_table(dev, &opts->pwd, opts->sp, opts->auth, opts->uid, opts->start, opts->end, buffer, is_set);
@@ -2915,7 +3122,9 @@ static int byte_table_handle(bool is_set)
         printf_buffer(buffer, buffer_size);
 
 cleanup:
-    if (buffer)
+    if (file_mmap != MAP_FAILED)
+        munmap(file_mmap, buffer_size);
+    else if (buffer)
         free(buffer);
 
 deinit:
@@ -2946,15 +3155,15 @@ static int reactivate_sp_handle(void)
     if (ret)
         goto deinit;
 
-    ret = get_opal_sp_uid(opts->sp, opts->sp_uid);
+    ret = get_opal_sp_uid(opts->sp, &opts->sp_uid);
     if (ret)
         goto deinit;
 
-    ret = get_opal_sp_uid(opts->target_sp, opts->target_sp_uid);
+    ret = get_opal_sp_uid(opts->target_sp, &opts->target_sp_uid);
     if (ret)
         goto deinit;
 
-    ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, opts->auth_uid);
+    ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, &opts->auth_uid);
     if (ret)
         goto deinit;
 
@@ -2979,11 +3188,11 @@ static int assign_handle(void)
     if (ret)
         goto deinit;
 
-    ret = get_opal_sp_uid(opts->sp, opts->sp_uid);
+    ret = get_opal_sp_uid(opts->sp, &opts->sp_uid);
     if (ret)
         goto deinit;
 
-    ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, opts->auth_uid);
+    ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, &opts->auth_uid);
     if (ret)
         goto deinit;
 
@@ -2994,7 +3203,7 @@ static int assign_handle(void)
         sedcli_printf(LOG_INFO, "Namespace ID: %u\n", locking_object.nsid);
         sedcli_printf(LOG_INFO, "UID (hex): ");
         for (uint8_t i = 0; i < OPAL_UID_LENGTH; i++) {
-            sedcli_printf(LOG_INFO, "%02x", locking_object.uid[i]);
+            sedcli_printf(LOG_INFO, "%02x", uid_get_byte(locking_object.uid, i));
             if (i < OPAL_UID_LENGTH - 1)
                 sedcli_printf(LOG_INFO, "-");
             else
@@ -3022,11 +3231,11 @@ static int deassign_handle(void)
     if (ret)
         goto deinit;
 
-    ret = get_opal_sp_uid(opts->sp, opts->sp_uid);
+    ret = get_opal_sp_uid(opts->sp, &opts->sp_uid);
     if (ret)
         goto deinit;
 
-    ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, opts->auth_uid);
+    ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, &opts->auth_uid);
     if (ret)
         goto deinit;
 
@@ -3038,6 +3247,49 @@ deinit:
     return ret;
 }
 
+static void print_next_uids(const struct sed_next_uids *next_uids, uint32_t first_row)
+{
+    for (uint32_t i = 0; i < next_uids->size; i++) {
+        sedcli_printf(LOG_INFO, "%04d: ", first_row + i);
+        for (uint8_t j = 0; j < OPAL_UID_LENGTH; j++) {
+            sedcli_printf(LOG_INFO, "%02x", uid_get_byte(next_uids->uids[i], j));
+            if (j < OPAL_UID_LENGTH - 1 )
+                sedcli_printf(LOG_INFO, "-");
+        }
+        sedcli_printf(LOG_INFO, "\n");
+    }
+}
+
+static int table_iter_all(struct sed_device *dev)
+{
+    struct sed_table_iter iter;
+    int ret = sed_table_iter_start(dev, &opts->pwd, opts->sp_uid, opts->auth_uid, opts->uid, opts->count, &iter);
+    if (ret)
+        return ret;
+
+    // resume after the row given with --where
+    iter.where = opts->where;
+
+    uint32_t rows = 0;
+    while (!iter.done) {
+        ret = sed_table_iter_next(dev, &iter);
+        if (ret)
+            break;
+
+        print_next_uids(&iter.page, rows);
+        rows += iter.page.size;
+    }
+
+    int end_ret = sed_table_iter_end(dev, &iter);
+    if (ret == SED_SUCCESS)
+        ret = end_ret;
+
+    if (ret == SED_SUCCESS)
+        sedcli_printf(LOG_INFO, "rows (%d)\n", rows);
+
+    return ret;
+}
+
 static int table_next_handle(void)
 {
     struct sed_device *dev = NULL;
@@ -3050,39 +3302,27 @@ static int table_next_handle(void)
     if (ret)
         goto deinit;
 
-    uint8_t *where = opts->where;
-    uint8_t opal_uid_none[] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
-    if (compare_uid(opts->where, opal_uid_none))
-        where = NULL;
-
-    ret = get_opal_sp_uid(opts->sp, opts->sp_uid);
+    ret = get_opal_sp_uid(opts->sp, &opts->sp_uid);
     if (ret)
         goto deinit;
 
-    ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, opts->auth_uid);
+    ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, &opts->auth_uid);
     if (ret)
         goto deinit;
 
+    if (opts->all_rows) {
+        ret = table_iter_all(dev);
+        goto deinit;
+    }
+
     struct sed_next_uids next_uids = { 0 };
-    ret = sed_table_next(dev, &opts->pwd, opts->sp_uid, opts->auth_uid, opts->uid, where, opts->count, &next_uids);
+    ret = sed_table_next(dev, &opts->pwd, opts->sp_uid, opts->auth_uid, opts->uid, opts->where, opts->count, &next_uids);
     if (ret == SED_SUCCESS) {
         sedcli_printf(LOG_INFO, "rows (%d):\n", next_uids.size);
-        for (uint16_t i = 0; i < next_uids.size; i++) {
-            sedcli_printf(LOG_INFO, "%04d: ", i);
-            for (uint8_t j = 0; j < OPAL_UID_LENGTH; j++) {
-                sedcli_printf(LOG_INFO, "%02x", next_uids.uids[i][j]);
-                if (j < OPAL_UID_LENGTH - 1 )
-                    sedcli_printf(LOG_INFO, "-");
-            }
-            sedcli_printf(LOG_INFO, "\n");
-        }
+        print_next_uids(&next_uids, 0);
     }
 
-    if (next_uids.size > 0) {
-        for (uint16_t i = 0; i < next_uids.size; i++)
-            free(next_uids.uids[i]);
-        free(next_uids.uids);
-    }
+    sed_next_uids_free(&next_uids);
 
 deinit:
     sed_deinit(dev);
@@ -3102,11 +3342,11 @@ static int get_acl_handle(void)
     if (ret)
         goto deinit;
 
-    ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, opts->auth_uid);
+    ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, &opts->auth_uid);
     if (ret)
         goto deinit;
 
-    ret = get_opal_sp_uid(opts->sp, opts->sp_uid);
+    ret = get_opal_sp_uid(opts->sp, &opts->sp_uid);
     if (ret)
         goto deinit;
 
@@ -3114,22 +3354,10 @@ static int get_acl_handle(void)
     ret = sed_get_acl(dev, &opts->pwd, opts->sp_uid, opts->auth_uid, opts->uid, opts->method, &next_uids);
     if (ret == SED_SUCCESS) {
         sedcli_printf(LOG_INFO, "rows (%d):\n", next_uids.size);
-        for (uint16_t i = 0; i < next_uids.size; i++) {
-            sedcli_printf(LOG_INFO, "%04d: ", i);
-            for (uint8_t j = 0; j < OPAL_UID_LENGTH; j++) {
-                sedcli_printf(LOG_INFO, "%02x", next_uids.uids[i][j]);
-                if (j < OPAL_UID_LENGTH - 1 )
-                    sedcli_printf(LOG_INFO, "-");
-            }
-            sedcli_printf(LOG_INFO, "\n");
-        }
+        print_next_uids(&next_uids, 0);
     }
 
-    if (next_uids.size > 0) {
-        for (uint16_t i = 0; i < next_uids.size; i++)
-            free(next_uids.uids[i]);
-        free(next_uids.uids);
-    }
+    sed_next_uids_free(&next_uids);
 
 deinit:
     sed_deinit(dev);
@@ -3167,15 +3395,15 @@ static int set_password_handle(void)
         goto deinit;
     }
 
-    ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, opts->auth_uid);
+    ret = get_opal_user_auth_uid(opts->auth, opts->auth_is_uid, &opts->auth_uid);
     if (ret)
         goto deinit;
 
-    ret = get_opal_user_auth_uid(opts->user, opts->user_is_uid, opts->user_uid);
+    ret = get_opal_user_auth_uid(opts->user, opts->user_is_uid, &opts->user_uid);
     if (ret)
         goto deinit;
 
-    ret = get_opal_sp_uid(opts->sp, opts->sp_uid);
+    ret = get_opal_sp_uid(opts->sp, &opts->sp_uid);
     if (ret)
         goto deinit;
 
@@ -3317,6 +3545,101 @@ static int block_sid_handle(void)
     return ret;
 }
 
+static long elapsed_ms(const struct timespec *start)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (now.tv_sec - start->tv_sec) * 1000 + (now.tv_nsec - start->tv_nsec) / 1000000;
+}
+
+static int harden_device(const char *dev_path, const struct timespec *start)
+{
+    struct sed_device *dev = NULL;
+    int ret = sed_init(&dev, dev_path, false);
+    if (ret) {
+        sedcli_printf(LOG_ERR, "%s: initialization failed: %d\n", dev_path, ret);
+        return ret;
+    }
+
+    ret = sed_issue_block_sid_cmd(dev, opts->hardware_reset);
+    if (ret) {
+        sedcli_printf(LOG_ERR, "%s: Block SID failed: %d\n", dev_path, ret);
+        goto deinit;
+    }
+    sedcli_printf(LOG_INFO, "%s: Block SID issued after %ld ms\n", dev_path, elapsed_ms(start));
+
+    if (!mbr_done)
+        goto deinit;
+
+    ret = check_current_levl0_discovery(dev);
+    if (ret) {
+        sedcli_printf(LOG_ERR, "%s: MBR Done skipped\n", dev_path);
+        goto deinit;
+    }
+
+    ret = sed_mbr_done(dev, &opts->pwd, opts->done);
+    if (ret) {
+        sedcli_printf(LOG_ERR, "%s: MBR Done failed: %d\n", dev_path, ret);
+        goto deinit;
+    }
+    sedcli_printf(LOG_INFO, "%s: MBR Done set after %ld ms\n", dev_path, elapsed_ms(start));
+
+deinit:
+    sed_deinit(dev);
+
+    return ret;
+}
+
+/*
+ * Every device is handled by its own child process, so Block SID reaches all
+ * drives at once and the Admin1 sessions needed for MBR Done overlap instead of
+ * running back to back. Processes are used rather than threads because libsed
+ * command templates are shared between sessions.
+ */
+static int harden_handle(void)
+{
+    if (mbr_done) {
+        sedcli_printf(LOG_INFO, "Enter Admin1 password:");
+        int ret = read_password(&opts->pwd);
+        if (ret)
+            return ret;
+    }
+
+    pid_t pids[MAX_HARDEN_DEVICES];
+    uint8_t failed = 0;
+    struct timespec start;
+
+    fflush(stdout);
+    fflush(stderr);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (uint8_t i = 0; i < harden_dev_count; i++) {
+        pids[i] = fork();
+        if (pids[i] == 0) {
+            int ret = harden_device(harden_dev_paths[i], &start);
+            fflush(stdout);
+            exit(ret ? FAILURE : SUCCESS);
+        }
+
+        if (pids[i] == -1)
+            sedcli_printf(LOG_ERR, "%s: unable to spawn worker\n", harden_dev_paths[i]);
+    }
+
+    for (uint8_t i = 0; i < harden_dev_count; i++) {
+        int status = 0;
+
+        if (pids[i] == -1 || waitpid(pids[i], &status, 0) == -1 ||
+            !WIFEXITED(status) || WEXITSTATUS(status) != SUCCESS)
+            failed++;
+    }
+
+    sedcli_printf(LOG_INFO, "Hardening completed on %u of %u devices in %ld ms\n",
+        harden_dev_count - failed, harden_dev_count, elapsed_ms(&start));
+
+    return failed ? -EIO : SUCCESS;
+}
+
 static int add_user_lr_handle(void)
 {
     struct sed_device *dev = NULL;